@@ -0,0 +1,66 @@
+<?hh
+
+// --
+// Combines the results of a sharded run, see --shard.
+//
+// usage: hhvm merge-shards.hh [--junit=<merged.xml>] [--coverage-baseline=<merged>]
+//          [--junit-shard=<shard.xml> ...] [--coverage-shard=<baseline> ...]
+//
+// The merged coverage baseline renders the reports for the whole suite with:
+//   phpunit --coverage-baseline=<merged> --coverage-incremental --coverage-html=<dir>
+// --
+
+$projectRoot = dirname(dirname(dirname(dirname(dirname(__FILE__)))));
+
+require_once $projectRoot.'/vendor/autoload.php';
+require_once $projectRoot.'/vendor/zynga/phpunit/vendor/autoload.php';
+
+use Zynga\PHPUnit\V2\ShardMerger;
+
+$junitOutput = '';
+$coverageOutput = '';
+$junitShards = Vector {};
+$coverageShards = Vector {};
+
+for ($i = 1; $i < count($argv); $i++) {
+
+  $arg = $argv[$i];
+  $value = substr($arg, strpos($arg, '=') + 1);
+
+  if (strpos($arg, '--junit=') === 0) {
+    $junitOutput = $value;
+  } else if (strpos($arg, '--coverage-baseline=') === 0) {
+    $coverageOutput = $value;
+  } else if (strpos($arg, '--junit-shard=') === 0) {
+    $junitShards->add($value);
+  } else if (strpos($arg, '--coverage-shard=') === 0) {
+    $coverageShards->add($value);
+  } else {
+    echo "unknown argument=$arg\n";
+    exit(1);
+  }
+
+}
+
+$merger = new ShardMerger();
+$exitCode = 0;
+
+if ($junitOutput != '') {
+  if ($merger->mergeJUnit($junitShards, $junitOutput) === true) {
+    echo date('r')." - merged shards=".$junitShards->count()." junit=$junitOutput\n";
+  } else {
+    echo date('r')." - FAILURE - could not merge junit logs into $junitOutput\n";
+    $exitCode = 1;
+  }
+}
+
+if ($coverageOutput != '') {
+  if ($merger->mergeCoverage($coverageShards, $coverageOutput) === true) {
+    echo date('r')." - merged shards=".$coverageShards->count()." coverage=$coverageOutput\n";
+  } else {
+    echo date('r')." - FAILURE - could not merge coverage into $coverageOutput\n";
+    $exitCode = 1;
+  }
+}
+
+exit($exitCode);
@@ -0,0 +1,89 @@
+<?hh
+
+// --
+// Hands a phpunit run to a running phpunit-daemon and streams back its
+// output, exiting with the run's exit code.
+//
+// usage: hhvm phpunit-client.hh [--daemon-socket=<path>] [--daemon-stop] <phpunit args>
+//
+// Only the daemon classes are loaded here, from this package rather than the
+// project it is installed in, the client itself is meant to start as fast as
+// hhvm does.
+// --
+$projectRoot = dirname(dirname(dirname(dirname(dirname(__FILE__)))));
+
+require_once dirname(__DIR__) . '/src/Zynga/PHPUnit/V2/RunnerDaemon.hh';
+require_once dirname(__DIR__) . '/src/Zynga/PHPUnit/V2/RunnerDaemon/OutputReader.hh';
+
+use Zynga\PHPUnit\V2\RunnerDaemon;
+use Zynga\PHPUnit\V2\RunnerDaemon\OutputReader;
+
+$userName = 'unknown';
+
+if (isset($_ENV['USER'])) {
+  $userName = $_ENV['USER'];
+} else {
+  $userName = get_current_user();
+}
+
+$socketPath = RunnerDaemon::getDefaultSocketPath($projectRoot, $userName);
+$request = array('cwd' => getcwd(), 'argv' => array($argv[0]));
+
+for ($i = 1; $i < count($argv); $i++) {
+
+  $arg = $argv[$i];
+
+  if (strpos($arg, '--daemon-socket=') === 0) {
+    $socketPath = substr($arg, strlen('--daemon-socket='));
+  } else if ($arg == '--daemon-stop') {
+    $request = array('command' => 'stop');
+  } else if (isset($request['argv'])) {
+    $request['argv'][] = $arg;
+  }
+
+}
+
+$errorNumber = 0;
+$errorString = '';
+
+$connection = @stream_socket_client(
+  'unix://' . $socketPath,
+  $errorNumber,
+  $errorString,
+  5.0
+);
+
+if (!is_resource($connection)) {
+  echo date('r') . " - FAILURE - no daemon listening socket=$socketPath, start one with bin/phpunit-daemon\n";
+  exit(255);
+}
+
+fwrite($connection, json_encode($request) . "\n");
+
+$reader = new OutputReader();
+
+while (!feof($connection)) {
+
+  $chunk = fread($connection, 8192);
+
+  if (!is_string($chunk) || $chunk === '') {
+    continue;
+  }
+
+  echo $reader->feed($chunk);
+
+}
+
+fclose($connection);
+
+list($output, $exitCode) = $reader->finish();
+
+echo $output;
+
+if ($exitCode === null) {
+  // the daemon went away before the run could report.
+  echo date('r') . " - FAILURE - run ended without an exit code\n";
+  $exitCode = 255;
+}
+
+exit($exitCode);
@@ -0,0 +1,51 @@
+<?hh
+
+// --
+// Starts a warm runner that serves phpunit runs over a unix socket, see
+// phpunit-client.
+//
+// usage: hhvm phpunit-daemon.hh [--socket=<path>] [--workers=<n>]
+//
+// --workers spreads the up front analysis of the whitelist over n processes.
+// --
+$projectRoot = dirname(dirname(dirname(dirname(dirname(__FILE__)))));
+
+require_once $projectRoot . '/src/autoload.hh';
+
+use Zynga\Framework\Environment\CodePath\V1\CodePath;
+use Zynga\PHPUnit\V2\RunnerDaemon;
+
+$userName = 'unknown';
+
+if (isset($_ENV['USER'])) {
+  $userName = $_ENV['USER'];
+} else {
+  $userName = get_current_user();
+}
+
+if ( CodePath::getRoot() == '' ) {
+  CodePath::setRoot($projectRoot);
+}
+
+$socketPath = RunnerDaemon::getDefaultSocketPath($projectRoot, $userName);
+$workers = 1;
+
+for ($i = 1; $i < count($argv); $i++) {
+
+  $arg = $argv[$i];
+  $value = substr($arg, strpos($arg, '=') + 1);
+
+  if (strpos($arg, '--socket=') === 0) {
+    $socketPath = $value;
+  } else if (strpos($arg, '--workers=') === 0) {
+    $workers = intval($value);
+  } else {
+    echo "unknown argument=$arg\n";
+    exit(1);
+  }
+
+}
+
+$daemon = new RunnerDaemon($projectRoot, $userName, $socketPath, $workers);
+
+exit($daemon->run());
@@ -10,6 +10,7 @@
 
 use Zynga\PHPUnit\V2\Interfaces\TestInterface;
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 use \Exception;
 
 /**
@@ -133,6 +134,16 @@ abstract class PHPUnit_Extensions_TicketListener implements TestListenerInterfac
         }
     }
 
+    /**
+     * The resources a test used.
+     *
+     * @param TestInterface $test
+     * @param TestProfile   $profile
+     */
+    public function addTestProfile(TestInterface $test, TestProfile $profile)
+    {
+    }
+
     /**
      * A test ended.
      *
@@ -11,6 +11,7 @@
 
 use Zynga\PHPUnit\V2\Interfaces\TestInterface;
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 
 /**
  * An empty Listener that can be extended to implement TestListener
@@ -64,6 +65,11 @@ abstract class PHPUnit_Framework_BaseTestListener
 
   public function startTest(TestInterface $test): void {}
 
+  public function addTestProfile(
+    TestInterface $test,
+    TestProfile $profile,
+  ): void {}
+
   public function endTest(TestInterface $test, float $time): void {}
 
   public function flush(): void {}
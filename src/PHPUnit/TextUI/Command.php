@@ -8,10 +8,14 @@
  * file that was distributed with this source code.
  */
 
+use SebastianBergmann\CodeCoverage\CodeCoverage;
 use Zynga\Framework\ReflectionCache\V1\ReflectionClasses;
 use Zynga\PHPUnit\V2\FileLoader;
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
 use Zynga\PHPUnit\V2\TestSuite;
+use Zynga\PHPUnit\V2\TestSuite\DiscoveryIndex;
+use Zynga\PHPUnit\V2\TestSuite\Sharding;
+use Zynga\PHPUnit\V2\TestSuite\TestOrder;
 
 /**
  * A TestRunner for the Command Line Interface (CLI)
@@ -44,11 +48,15 @@ class PHPUnit_TextUI_Command
         'colors=='                => null,
         'columns='                => null,
         'configuration='          => null,
+        'coverage-aggregate='     => null,
+        'coverage-baseline='      => null,
         'coverage-clover='        => null,
         'coverage-crap4j='        => null,
         'coverage-html='          => null,
+        'coverage-incremental'    => null,
         'coverage-php='           => null,
         'coverage-text=='         => null,
+        'coverage-workers='       => null,
         'coverage-xml='           => null,
         'debug'                   => null,
         'disallow-test-output'    => null,
@@ -70,10 +78,14 @@ class PHPUnit_TextUI_Command
         'no-configuration'        => null,
         'no-coverage'             => null,
         'no-globals-backup'       => null,
+        'order-by='               => null,
         'printer='                => null,
         'process-isolation'       => null,
         'repeat='                 => null,
+        'shard='                  => null,
+        'shard-manifest='         => null,
         'report-useless-tests'    => null,
+        'result-cache='           => null,
         'reverse-list'            => null,
         'static-backup'           => null,
         'stderr'                  => null,
@@ -87,6 +99,7 @@ class PHPUnit_TextUI_Command
         'fail-on-risky'           => null,
         'strict-coverage'         => null,
         'disable-coverage-ignore' => null,
+        'discovery-index='        => null,
         'strict-global-state'     => null,
         'tap'                     => null,
         'teamcity'                => null,
@@ -98,9 +111,11 @@ class PHPUnit_TextUI_Command
         'testdox-xml='            => null,
         'test-suffix='            => null,
         'testsuite='              => null,
+        'timing-database='        => null,
         'verbose'                 => null,
         'version'                 => null,
-        'whitelist='              => null
+        'whitelist='              => null,
+        'workers='                => null
     ];
 
     /**
@@ -160,12 +175,24 @@ class PHPUnit_TextUI_Command
             );
         }
 
+        $discoveryIndex = TestSuite::getDiscoveryIndex();
+
+        if ($discoveryIndex instanceof DiscoveryIndex &&
+            $discoveryIndex->isDirty()) {
+            $discoveryIndex->save();
+        }
+
         if ($this->arguments['listGroups']) {
             $this->printVersionString();
 
             print "Available test group(s):\n";
 
-            $groups = $suite->getGroups();
+            if ($suite instanceof TestSuite) {
+                $groups = $suite->getPlan()->getGroupNames()->toArray();
+            } else {
+                $groups = $suite->getGroups()->toArray();
+            }
+
             sort($groups);
 
             foreach ($groups as $group) {
@@ -301,6 +328,14 @@ class PHPUnit_TextUI_Command
                     $this->arguments['configuration'] = $option[1];
                     break;
 
+                case '--coverage-aggregate':
+                    $this->arguments['coverageAggregate'] = $option[1];
+                    break;
+
+                case '--coverage-baseline':
+                    $this->arguments['coverageBaseline'] = $option[1];
+                    break;
+
                 case '--coverage-clover':
                     $this->arguments['coverageClover'] = $option[1];
                     break;
@@ -313,6 +348,10 @@ class PHPUnit_TextUI_Command
                     $this->arguments['coverageHtml'] = $option[1];
                     break;
 
+                case '--coverage-incremental':
+                    $this->arguments['coverageIncremental'] = true;
+                    break;
+
                 case '--coverage-php':
                     $this->arguments['coveragePHP'] = $option[1];
                     break;
@@ -327,6 +366,10 @@ class PHPUnit_TextUI_Command
                     $this->arguments['coverageTextShowOnlySummary']    = false;
                     break;
 
+                case '--coverage-workers':
+                    $this->arguments['coverageWorkers'] = (int) $option[1];
+                    break;
+
                 case '--coverage-xml':
                     $this->arguments['coverageXml'] = $option[1];
                     break;
@@ -464,6 +507,52 @@ class PHPUnit_TextUI_Command
                     $this->arguments['processIsolation'] = true;
                     break;
 
+                case '--workers':
+                    $this->arguments['workers'] = (int) $option[1];
+                    break;
+
+                case '--timing-database':
+                    $this->arguments['timingDatabase'] = $option[1];
+                    break;
+
+                case '--shard':
+                    if (Sharding::parseShard($option[1]) === null) {
+                        $this->showError(
+                            sprintf(
+                                'Invalid shard "%s", expected <k>/<n> with 1 <= k <= n.',
+                                $option[1]
+                            )
+                        );
+                    }
+                    $this->arguments['shard'] = $option[1];
+                    break;
+
+                case '--shard-manifest':
+                    $this->arguments['shardManifest'] = $option[1];
+                    break;
+
+                case '--order-by':
+                    if (TestOrder::parseOrder($option[1]) === null) {
+                        $this->showError(
+                            sprintf(
+                                'Invalid order "%s", expected a comma separated list of defects, changed and fastest.',
+                                $option[1]
+                            )
+                        );
+                    }
+                    $this->arguments['orderBy'] = $option[1];
+                    break;
+
+                case '--result-cache':
+                    $this->arguments['resultCache'] = $option[1];
+                    break;
+
+                case '--discovery-index':
+                    $discoveryIndex = new DiscoveryIndex($option[1]);
+                    $discoveryIndex->load();
+                    TestSuite::setDiscoveryIndex($discoveryIndex);
+                    break;
+
                 case '--repeat':
                     $this->arguments['repeat'] = (int) $option[1];
                     break;
@@ -646,6 +735,23 @@ class PHPUnit_TextUI_Command
 
         $this->handleCustomTestSuite();
 
+        if (isset($this->arguments['coverageIncremental']) &&
+            !isset($this->arguments['coverageBaseline'])) {
+            $this->showError(
+                '--coverage-incremental needs a --coverage-baseline to select tests against.'
+            );
+        }
+
+        // the baseline maps lines to the classes that ran them, a suite wide
+        // aggregate only knows one pseudo test.
+        if (isset($this->arguments['coverageAggregate']) &&
+            $this->arguments['coverageAggregate'] === CodeCoverage::AGGREGATE_SUITE &&
+            isset($this->arguments['coverageBaseline'])) {
+            $this->showError(
+                '--coverage-baseline cannot be recorded with --coverage-aggregate=suite.'
+            );
+        }
+
         if (!isset($this->arguments['test'])) {
             if (isset($this->options[1][1])) {
               $this->arguments['test'] = $this->options[1][1];
@@ -1022,12 +1128,22 @@ Usage: phpunit [options] UnitTest [UnitTest.php]
 
 Code Coverage Options:
 
+  --coverage-aggregate <suite|class>
+                            Collect coverage across the whole suite or each
+                            test class instead of per test.
+  --coverage-baseline <file>
+                            Record line to test attribution to <file> for
+                            incremental runs.
   --coverage-clover <file>  Generate code coverage report in Clover XML format.
   --coverage-crap4j <file>  Generate code coverage report in Crap4J XML format.
   --coverage-html <dir>     Generate code coverage report in HTML format.
+  --coverage-incremental    Only run tests that touched files changed since
+                            the --coverage-baseline and merge in the rest.
   --coverage-php <file>     Export PHP_CodeCoverage object to file.
   --coverage-text=<file>    Generate code coverage report in text format.
                             Default: Standard output.
+  --coverage-workers <n>    Analyze whitelisted files and render HTML report
+                            pages with <n> forked workers.
   --coverage-xml <dir>      Generate code coverage report in PHPUnit XML format.
   --whitelist <dir>         Whitelist <dir> for code coverage analysis.
   --disable-coverage-ignore Disable annotations for ignoring code coverage.
@@ -1052,6 +1168,8 @@ Test Selection Options:
   --list-groups             List available test groups.
   --test-suffix ...         Only search for test in files with specified
                             suffix(es). Default: Test.php,.phpt
+  --discovery-index <file>  Find test classes by scanning test files, caching
+                            the scans in <file>, instead of including them.
 
 Test Execution Options:
 
@@ -1064,6 +1182,15 @@ Test Execution Options:
   --disallow-todo-tests     Disallow @todo-annotated tests.
 
   --process-isolation       Run each test in a separate PHP process.
+  --workers <n>             Run test classes across <n> forked workers.
+  --timing-database <file>  Record test times to <file> and use them to
+                            balance --workers and --shard.
+  --shard <k>/<n>           Only run shard <k> of <n>, split by test class.
+  --shard-manifest <file>   Write the classes of every shard to <file>, or
+                            follow the split in <file> when it exists.
+  --result-cache <file>     Record the outcome of every test to <file>.
+  --order-by <modes>        Run test classes ordered by defects, changed
+                            and/or fastest, e.g. --order-by=defects,fastest.
   --no-globals-backup       Do not backup and restore \$GLOBALS for each test.
   --static-backup           Backup and restore static attributes for each test.
 
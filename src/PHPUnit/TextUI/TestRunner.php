@@ -23,11 +23,17 @@ use SebastianBergmann\CodeCoverage\Report\Text as TextReport;
 use SebastianBergmann\CodeCoverage\Report\Xml\Facade as XmlReport;
 use SebastianBergmann\Environment\Runtime;
 
+use Zynga\CodeBase\V1\CoverageBaseline;
+
 use Zynga\PHPUnit\V2\Filter\Container as FilterContainer;
 use Zynga\PHPUnit\V2\Interfaces\TestInterface;
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
 use Zynga\PHPUnit\V2\TestResult;
 use Zynga\PHPUnit\V2\TestSuite;
+use Zynga\PHPUnit\V2\TestSuite\ResultCache;
+use Zynga\PHPUnit\V2\TestSuite\Sharding;
+use Zynga\PHPUnit\V2\TestSuite\TestOrder;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
 use Zynga\PHPUnit\V2\Output\ResultPrinter;
 
 /**
@@ -157,6 +163,119 @@ class PHPUnit_TextUI_TestRunner extends PHPUnit_Runner_BaseTestRunner
 
     }
 
+    /**
+     * Narrows the suite down to the test classes that touched a file changed
+     * since the recorded baseline, or that the baseline knows nothing about.
+     *
+     * @param TestInterface    $suite
+     * @param CoverageBaseline $baseline
+     */
+    private function selectIncrementalTests(TestInterface $suite, CoverageBaseline $baseline)
+    {
+        if (!$baseline->load()) {
+            $this->writeMessage(
+                'Incremental',
+                'No baseline at ' . $baseline->getBaselineFile() . ', running all tests'
+            );
+
+            return;
+        }
+
+        if (!$suite instanceof TestSuite) {
+            return;
+        }
+
+        $baseline->computeSelection(
+            new Vector($this->codeCoverageFilter->getWhitelist())
+        );
+
+        $kept = $suite->retainTests(
+            function (TestInterface $test) use ($baseline) {
+                return $baseline->isTestClassSelected(get_class($test));
+            }
+        );
+
+        $this->writeMessage(
+            'Incremental',
+            sprintf(
+                '%d changed files, running %d tests',
+                $baseline->getChangedFiles()->count(),
+                $kept
+            )
+        );
+    }
+
+    /**
+     * Narrows the suite down to the test classes of one shard. An existing
+     * manifest decides the split, otherwise it is worked out from the local
+     * timings and optionally written out for the other machines to follow.
+     *
+     * @param TestInterface       $suite
+     * @param array               $arguments
+     * @param TimingDatabase|null $timingDatabase
+     */
+    private function selectShard(TestInterface $suite, array $arguments, $timingDatabase)
+    {
+        if (!$suite instanceof TestSuite) {
+            return;
+        }
+
+        list($shardIndex, $shardCount) = Sharding::parseShard($arguments['shard']);
+
+        $tests    = $suite->getPlan()->getTests();
+        $sharding = new Sharding($shardCount, $timingDatabase);
+
+        if (isset($arguments['shardManifest']) &&
+            file_exists($arguments['shardManifest'])) {
+            $manifestShards = $sharding->readManifest($arguments['shardManifest']);
+
+            if ($manifestShards === null) {
+                $this->runFailed(
+                    sprintf(
+                        'Sharding: %s is not a manifest for %d shards.',
+                        $arguments['shardManifest'],
+                        $shardCount
+                    )
+                );
+            }
+
+            $shards = $sharding->partitionFromManifest($tests, $manifestShards);
+        } else {
+            $shards = $sharding->partition($tests);
+
+            if (isset($arguments['shardManifest']) &&
+                !$sharding->writeManifest($arguments['shardManifest'], $tests, $shards)) {
+                $this->writeMessage(
+                    'Sharding',
+                    'Failed to write ' . $arguments['shardManifest']
+                );
+            }
+        }
+
+        $selected = [];
+
+        foreach ($shards[$shardIndex - 1] as $className) {
+            $selected[$className] = true;
+        }
+
+        $kept = $suite->retainTests(
+            function (TestInterface $test) use ($selected) {
+                return isset($selected[get_class($test)]);
+            }
+        );
+
+        $this->writeMessage(
+            'Sharding',
+            sprintf(
+                'shard %d of %d, running %d tests of %d',
+                $shardIndex,
+                $shardCount,
+                $kept,
+                $tests->count()
+            )
+        );
+    }
+
     /**
      * @param TestInterface $suite
      * @param array                  $arguments
@@ -387,6 +506,17 @@ class PHPUnit_TextUI_TestRunner extends PHPUnit_Runner_BaseTestRunner
                 $this->codeCoverage->setDisableIgnoredLines(true);
             }
 
+            if (isset($arguments['coverageAggregate'])) {
+                $this->codeCoverage->setAggregate($arguments['coverageAggregate']);
+            }
+
+            if (isset($arguments['coverageWorkers']) &&
+                $arguments['coverageWorkers'] > 1) {
+                $this->codeCoverage->setAnalysisWorkers(
+                    $arguments['coverageWorkers']
+                );
+            }
+
             if (isset($arguments['whitelist'])) {
                 $this->codeCoverageFilter->addDirectoryToWhitelist($arguments['whitelist']);
             }
@@ -436,11 +566,98 @@ class PHPUnit_TextUI_TestRunner extends PHPUnit_Runner_BaseTestRunner
         $result->setTimeoutForMediumTests($arguments['timeoutForMediumTests']);
         $result->setTimeoutForLargeTests($arguments['timeoutForLargeTests']);
 
+        if (isset($arguments['workers'])) {
+            $result->setWorkers($arguments['workers']);
+        }
+
+        $timingDatabase = null;
+
+        if (isset($arguments['timingDatabase'])) {
+            $timingDatabase = new TimingDatabase($arguments['timingDatabase']);
+            $timingDatabase->load();
+            $result->setTimingDatabase($timingDatabase);
+
+            if ($suite instanceof TestSuite) {
+                $suite->setExpectedDataSetCounts($timingDatabase);
+            }
+        }
+
+        $resultCache = null;
+
+        if (isset($arguments['resultCache'])) {
+            $resultCache = new ResultCache($arguments['resultCache']);
+            $resultCache->load();
+        }
+
+        $coverageBaseline = null;
+
+        if ($codeCoverageReports > 0 && isset($arguments['coverageBaseline'])) {
+            $coverageBaseline = new CoverageBaseline($arguments['coverageBaseline']);
+
+            if (isset($arguments['coverageIncremental'])) {
+                $this->selectIncrementalTests($suite, $coverageBaseline);
+            }
+        } elseif (isset($arguments['coverageIncremental'])) {
+            $this->writeMessage(
+                'Incremental',
+                'No coverage report requested, running all tests'
+            );
+        }
+
+        if (isset($arguments['shard'])) {
+            $this->selectShard($suite, $arguments, $timingDatabase);
+        }
+
+        if (isset($arguments['orderBy']) && $suite instanceof TestSuite) {
+            $order = new TestOrder(
+                TestOrder::parseOrder($arguments['orderBy']),
+                $resultCache,
+                $timingDatabase
+            );
+            $order->reorder($suite);
+        }
+
         $suite->run($result);
 
         unset($suite);
         $result->flushListeners();
 
+        if ($codeCoverageReports > 0) {
+            $this->codeCoverage->flush();
+        }
+
+        if ($timingDatabase instanceof TimingDatabase &&
+            !$timingDatabase->save()) {
+            $this->writeMessage(
+                'Timing',
+                'Failed to write ' . $timingDatabase->getDatabaseFile()
+            );
+        }
+
+        if ($resultCache instanceof ResultCache) {
+            $resultCache->recordResult($result);
+
+            if (!$resultCache->save()) {
+                $this->writeMessage(
+                    'Ordering',
+                    'Failed to write ' . $resultCache->getCacheFile()
+                );
+            }
+        }
+
+        if ($coverageBaseline instanceof CoverageBaseline) {
+            if ($coverageBaseline->isLoaded()) {
+                $coverageBaseline->mergeInto();
+            }
+
+            if (!$coverageBaseline->save()) {
+                $this->writeMessage(
+                    'Incremental',
+                    'Failed to write ' . $coverageBaseline->getBaselineFile()
+                );
+            }
+        }
+
         if ($this->printer instanceof ResultPrinter) {
             $this->printer->printResult($result);
         }
@@ -501,6 +718,11 @@ class PHPUnit_TextUI_TestRunner extends PHPUnit_Runner_BaseTestRunner
                         )
                     );
 
+                    if (isset($arguments['coverageWorkers']) &&
+                        $arguments['coverageWorkers'] > 1) {
+                        $writer->setWorkers($arguments['coverageWorkers']);
+                    }
+
                     $writer->process($this->codeCoverage, $arguments['coverageHtml']);
 
                     $this->printer->write(date('r') . " - CodeCoverage::HTML - done output=$outputLocation\n");
@@ -196,6 +196,20 @@ class PHPUnit_Util_Configuration {
     return self::$instances[$realpath];
   }
 
+  /**
+   * Drops the cached configuration object so the next getInstance() call
+   * re-reads the file, used by long-lived runners once the file changes.
+   *
+   * @param string $filename
+   */
+  public static function forgetInstance($filename) {
+    $realpath = realpath($filename);
+
+    if ($realpath !== false) {
+      unset(self::$instances[$realpath]);
+    }
+  }
+
   /**
    * Returns the realpath to the configuration file.
    *
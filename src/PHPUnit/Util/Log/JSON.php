@@ -11,6 +11,7 @@
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
 use Zynga\PHPUnit\V2\TestCase;
 use Zynga\PHPUnit\V2\TestFailure;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 
 use \Exception;
 
@@ -209,6 +210,16 @@ class PHPUnit_Util_Log_JSON extends PHPUnit_Util_Printer implements TestListener
         );
     }
 
+    /**
+     * The resources a test used, written along with its outcome.
+     *
+     * @param TestInterface $test
+     * @param TestProfile   $profile
+     */
+    public function addTestProfile(TestInterface $test, TestProfile $profile)
+    {
+    }
+
     /**
      * A test ended.
      *
@@ -236,8 +247,7 @@ class PHPUnit_Util_Log_JSON extends PHPUnit_Util_Printer implements TestListener
         if ($test !== null && method_exists($test, 'hasOutput') && $test->hasOutput()) {
             $output = $test->getActualOutput();
         }
-        $this->write(
-            [
+        $event = [
             'event'   => 'test',
             'suite'   => $this->currentTestSuiteName,
             'test'    => $this->currentTestName,
@@ -246,8 +256,12 @@ class PHPUnit_Util_Log_JSON extends PHPUnit_Util_Printer implements TestListener
             'trace'   => $trace,
             'message' => PHPUnit_Util_String::convertToUtf8($message),
             'output'  => $output,
-            ]
-        );
+        ];
+        // the profile is taken right after the test ran, ahead of any defect.
+        if ($test instanceof TestCase && $test->getProfile() instanceof TestProfile) {
+            $event['profile'] = $test->getProfile()->toArray();
+        }
+        $this->write($event);
     }
 
     /**
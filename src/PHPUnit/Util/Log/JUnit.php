@@ -12,6 +12,7 @@ use Zynga\Framework\ReflectionCache\V1\ReflectionClasses;
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
 use Zynga\PHPUnit\V2\TestCase;
 use Zynga\PHPUnit\V2\TestFailure;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 
 use \Exception;
 
@@ -356,6 +357,32 @@ class PHPUnit_Util_Log_JUnit extends PHPUnit_Util_Printer implements TestListene
         $this->currentTestCase = $testCase;
     }
 
+    /**
+     * The resources a test used.
+     *
+     * @param TestInterface $test
+     * @param TestProfile   $profile
+     */
+    public function addTestProfile(TestInterface $test, TestProfile $profile)
+    {
+        if ($this->currentTestCase === null) {
+            return;
+        }
+
+        $this->currentTestCase->setAttribute(
+            'cpuTime',
+            sprintf('%F', $profile->getCpuTime())
+        );
+        $this->currentTestCase->setAttribute(
+            'memoryDelta',
+            $profile->getMemoryDelta()
+        );
+        $this->currentTestCase->setAttribute(
+            'peakMemory',
+            $profile->getPeakMemory()
+        );
+    }
+
     /**
      * A test ended.
      *
@@ -12,6 +12,7 @@ use Zynga\PHPUnit\V2\Interfaces\TestInterface;
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
 use Zynga\PHPUnit\V2\TestCase;
 use Zynga\PHPUnit\V2\TestFailure;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 
 use \Exception;
 
@@ -212,6 +213,16 @@ class PHPUnit_Util_Log_TAP extends PHPUnit_Util_Printer implements TestListenerI
         $this->testSuccessful = true;
     }
 
+    /**
+     * The resources a test used.
+     *
+     * @param TestInterface $test
+     * @param TestProfile   $profile
+     */
+    public function addTestProfile(TestInterface $test, TestProfile $profile)
+    {
+    }
+
     /**
      * A test ended.
      *
@@ -10,6 +10,7 @@
 
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
 use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 use Zynga\PHPUnit\V2\TestSuite;
 
 use \Exception;
@@ -294,6 +295,16 @@ abstract class PHPUnit_Util_TestDox_ResultPrinter extends PHPUnit_Util_Printer i
         $this->testStatus = PHPUnit_Runner_BaseTestRunner::STATUS_PASSED;
     }
 
+    /**
+     * The resources a test used.
+     *
+     * @param TestInterface $test
+     * @param TestProfile   $profile
+     */
+    public function addTestProfile(TestInterface $test, TestProfile $profile)
+    {
+    }
+
     /**
      * A test ended.
      *
@@ -11,6 +11,7 @@
 use Zynga\Framework\ReflectionCache\V1\ReflectionClasses;
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
 use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 use Zynga\PHPUnit\V2\TestSuite;
 /**
  * @since Class available since Release 5.4.0
@@ -159,6 +160,16 @@ class PHPUnit_Util_TestDox_ResultPrinter_XML extends PHPUnit_Util_Printer implem
         $this->exception = null;
     }
 
+    /**
+     * The resources a test used.
+     *
+     * @param TestInterface $test
+     * @param TestProfile   $profile
+     */
+    public function addTestProfile(TestInterface $test, TestProfile $profile)
+    {
+    }
+
     /**
      * A test ended.
      *
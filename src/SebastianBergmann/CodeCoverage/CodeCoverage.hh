@@ -33,6 +33,15 @@ use Zynga\CodeBase\V1\FileFactory;
  * Provides collection functionality for PHP code coverage information.
  */
 class CodeCoverage {
+  const string AGGREGATE_NONE = '';
+  const string AGGREGATE_SUITE = 'suite';
+  const string AGGREGATE_CLASS = 'class';
+
+  /**
+   * Test id the whole suite is attributed to when aggregating per suite.
+   */
+  const string AGGREGATE_SUITE_ID = 'AGGREGATE_SUITE';
+
   /**
    * @var Driver
    */
@@ -124,6 +133,45 @@ class CodeCoverage {
    */
   private $shouldCheckForDeadAndUnused = true;
 
+  /**
+   * Keep collecting across tests rather than starting and stopping the driver
+   * around each one, one of the AGGREGATE_* modes.
+   *
+   * @var string
+   */
+  private $aggregate = self::AGGREGATE_NONE;
+
+  /**
+   * Id the running aggregate collection will be attributed to, null when the
+   * driver is not collecting.
+   *
+   * @var string|null
+   */
+  private $aggregateId = null;
+
+  /**
+   * Number of forked workers used to analyze the whitelist
+   *
+   * @var int
+   */
+  private $analysisWorkers = 1;
+
+  /**
+   * The tree getReport() last built, shared by every report written from
+   * the same data. Dropped whenever collection starts or the data is
+   * cleared.
+   *
+   * @var Directory|null
+   */
+  private ?Directory $report = null;
+
+  /**
+   * Number of files FileFactory knew when the report was built.
+   *
+   * @var int
+   */
+  private int $reportFileCount = 0;
+
   private string $target;
 
   /**
@@ -171,20 +219,59 @@ class CodeCoverage {
    * @return Directory
    */
   public function getReport(): Directory {
+
+    $this->flush();
+
+    $fileCount = FileFactory::getFileCount();
+
+    $report = $this->report;
+
+    // files registered after the tree was built are not in it yet.
+    if ($report instanceof Directory && $this->reportFileCount == $fileCount) {
+      return $report;
+    }
+
     $builder = new Builder();
-    return $builder->build($this);
+
+    $report = $builder->build($this);
+
+    $this->report = $report;
+    $this->reportFileCount = $fileCount;
+
+    return $report;
+
+  }
+
+  /**
+   * Drops the cached report tree, its stats no longer match the data.
+   */
+  private function invalidateReport(): void {
+    $this->report = null;
+    $this->reportFileCount = 0;
   }
 
   /**
    * Clears collected code coverage data.
    */
   public function clear() {
+    $this->flush();
+    $this->invalidateReport();
     $this->isInitialized = false;
     $this->currentId = null;
     FileFactory::clear();
     $this->tests = [];
   }
 
+  /**
+   * Analyzes the whitelist up front rather than on the first start(), so
+   * forked test workers inherit the analysis instead of each redoing it.
+   */
+  public function initialize(): void {
+    if ($this->isInitialized === false) {
+      $this->initializeData();
+    }
+  }
+
   /**
    * Returns the filter object used.
    *
@@ -203,6 +290,7 @@ class CodeCoverage {
    * @return array
    */
   public function getData($raw = false) {
+    $this->flush();
     if (!$raw && $this->addUncoveredFilesFromWhitelist) {
       $this->addUncoveredFilesFromWhitelist();
     }
@@ -258,8 +346,29 @@ class CodeCoverage {
       $this->initializeData();
     }
 
+    $this->invalidateReport();
+
     $this->currentId = $id;
 
+    if ($this->aggregate !== self::AGGREGATE_NONE) {
+
+      $aggregateId = self::AGGREGATE_SUITE_ID;
+
+      if ($this->aggregate === self::AGGREGATE_CLASS) {
+        $aggregateId = get_class($id);
+      }
+
+      // still within the same aggregate, the driver is already collecting.
+      if ($this->aggregateId === $aggregateId) {
+        return;
+      }
+
+      $this->flush();
+
+      $this->aggregateId = $aggregateId;
+
+    }
+
     $this->driver->start($this->shouldCheckForDeadAndUnused);
   }
 
@@ -276,6 +385,12 @@ class CodeCoverage {
    */
   public function stop(): void {
 
+    // aggregates are only processed once they are flushed.
+    if ($this->aggregate !== self::AGGREGATE_NONE) {
+      $this->currentId = null;
+      return;
+    }
+
     // --
     // @TODO: $this->currentId can be null, and possibly not a test.
     // --
@@ -289,6 +404,21 @@ class CodeCoverage {
 
   }
 
+  /**
+   * Stops a running aggregate collection and processes its data.
+   */
+  public function flush(): void {
+
+    if ($this->aggregateId === null) {
+      return;
+    }
+
+    $this->driver->stop($this->aggregateId);
+
+    $this->aggregateId = null;
+
+  }
+
   /**
    * Appends code coverage data.
    *
@@ -538,6 +668,34 @@ class CodeCoverage {
     $this->ignoreDeprecatedCode = $flag;
   }
 
+  /**
+   * @param string $mode one of the AGGREGATE_* modes
+   *
+   * @throws InvalidArgumentException
+   */
+  public function setAggregate($mode) {
+    if ($mode !== self::AGGREGATE_NONE &&
+        $mode !== self::AGGREGATE_SUITE &&
+        $mode !== self::AGGREGATE_CLASS) {
+      throw InvalidArgumentException::create(1, "'suite' or 'class'");
+    }
+
+    $this->aggregate = $mode;
+  }
+
+  /**
+   * @param int $workers
+   *
+   * @throws InvalidArgumentException
+   */
+  public function setAnalysisWorkers($workers) {
+    if (!is_int($workers) || $workers < 1) {
+      throw InvalidArgumentException::create(1, 'positive integer');
+    }
+
+    $this->analysisWorkers = $workers;
+  }
+
   /**
    * @param array $whitelist
    */
@@ -831,6 +989,30 @@ class CodeCoverage {
 
     $fileCount = 0;
 
+    if ($this->analysisWorkers > 1) {
+
+      $toAnalyze = Vector {};
+
+      foreach ($this->filter->getWhitelist() as $file) {
+        if (!$this->filter->isFiltered($file)) {
+          $toAnalyze->add($file);
+        }
+      }
+
+      echo
+        date('r').
+        " - CodeCoverage::initalizeData - analyzing fileCount=".
+        $toAnalyze->count().
+        " workers=".
+        $this->analysisWorkers.
+        "\n"
+      ;
+
+      // the loop below then only picks up the already registered files.
+      FileFactory::preload($toAnalyze, $this->analysisWorkers);
+
+    }
+
     foreach ($this->filter->getWhitelist() as $file) {
 
       $this->initalizeData_DisplayPerFileData("whiteListedFile=$file");
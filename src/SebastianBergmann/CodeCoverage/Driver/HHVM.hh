@@ -17,7 +17,7 @@ use SebastianBergmann\CodeCoverage\Driver\HHVM\LineStack;
 use SebastianBergmann\CodeCoverage\Driver\HHVM\Logging as HHVM_Logging;
 use SebastianBergmann\TokenStream\Stream\CachingFactory;
 use Zynga\CodeBase\V1\FileFactory;
-use Zynga\CodeBase\V1\File\ExecutableRange;
+use Zynga\CodeBase\V1\TestIds;
 
 use \RuntimeException;
 
@@ -63,6 +63,29 @@ class HHVM {
 
     xdebug_stop_code_coverage();
 
+    $this->process($testId, $data);
+
+  }
+
+  /**
+   * Applies one test's worth of xdebug coverage data to the registered files.
+   *
+   * Each file is handled in a single pass: line to test attribution and the
+   * non executed states are recorded as the lines go by, executed lines are
+   * gathered up and marked in one bulk call so shared executable ranges only
+   * get expanded once.
+   *
+   * @param string $testId
+   * @param array  $data file => line => xdebug line state
+   */
+  public function process(
+    string $testId,
+    array<string, array<int, int>> $data,
+  ): void {
+
+    // interned once, every covered line only records the int.
+    $internedTestId = TestIds::intern($testId);
+
     foreach ($data as $fileName => $execStatuses) {
 
       // --
@@ -82,42 +105,23 @@ class HHVM {
 
       $processedFile = FileFactory::get($fileName);
 
+      $lineToTests = $processedFile->lineToTests();
+      $lineExecutionState = $processedFile->lineExecutionState();
+
+      $executedLines = Vector {};
+
       //echo "caputuring fileName=$fileName\n";
       foreach ($execStatuses as $lineNo => $lineState) {
-        $processedFile->setLineToTest($lineNo, $testId);
+        $lineToTests->add($lineNo, $internedTestId);
         if ($lineState >= Driver::LINE_EXECUTED) {
-          //echo "captured $lineNo : executed\n";
-          $processedFile->lineExecutionState()
-            ->set($lineNo, Driver::LINE_EXECUTED);
-
-          if ($processedFile->lineExecutionState()->isLineWithinExecutableRange(
-                $lineNo,
-              ) ===
-              true) {
-
-            $executableRanges = $processedFile->lineExecutionState()->getExecutableRanges($lineNo);
-
-            foreach ( $executableRanges as $executableRange ) {
-
-              if ($executableRange instanceof ExecutableRange) {
-                for (
-                $innerRange = $executableRange->getStart();
-                $innerRange <= $executableRange->getEnd();
-                $innerRange++
-                ) {
-                $processedFile->lineExecutionState()
-                  ->set($innerRange, Driver::LINE_EXECUTED);
-               }
-              }
-
-            }
-
-          }
+          $executedLines->add($lineNo);
         } else {
-          $processedFile->lineExecutionState()->set($lineNo, $lineState);
+          $lineExecutionState->set($lineNo, $lineState);
         }
       }
 
+      $lineExecutionState->markExecutedLines($executedLines);
+
     }
 
   }
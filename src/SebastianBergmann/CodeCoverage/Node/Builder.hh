@@ -14,8 +14,17 @@ namespace SebastianBergmann\CodeCoverage\Node;
 use SebastianBergmann\CodeCoverage\CodeCoverage;
 use Zynga\CodeBase\V1\FileFactory;
 
+// --
+// Builds the directory tree of the report from the files FileFactory knows.
+//
+// Every directory is created once, the first time a file below it turns up,
+// and attached to its parent right away, so building stays linear in the
+// number of files and directories.
+//
+// The tree is not kept here, CodeCoverage::getReport() caches it for as long
+// as its coverage data stays the same.
+// --
 class Builder {
-  private static ?Directory $_root = null;
 
   /**
    * @param CodeCoverage $coverage
@@ -23,12 +32,10 @@ class Builder {
    * @return Directory
    */
   public function build(CodeCoverage $coverage): Directory {
+    return $this->buildTree(FileFactory::getFileNames());
+  }
 
-    if (self::$_root instanceof Directory) {
-      return self::$_root;
-    }
-
-    $fileNames = FileFactory::getFileNames();
+  public function buildTree(Vector<string> $fileNames): Directory {
 
     $dirMap = Map {};
 
@@ -37,91 +44,44 @@ class Builder {
 
     $dirMap->set(DIRECTORY_SEPARATOR, $root);
 
-    // // Group all the files under their parental directories.
+    // Group all the files under their parental directories.
     foreach ($fileNames as $fileName) {
-
-      $directory = dirname($fileName);
-
-      $directoryEntry = $dirMap->get($directory);
-
-      //echo "directory=$directory\n";
-      //echo "  file=$fileName\n";
-
-      // we have a existing directory entry, feel free to add the file there.
-      if ($directoryEntry instanceof Directory) {
-
-        $directoryEntry->addFileFullPath($fileName);
-
-        continue;
-
-      }
-
-      // Create a new entry.
-      $directoryEntry = new Directory($directory);
-      $directoryEntry->addFileFullPath($fileName);
-      $dirMap->set($directory, $directoryEntry);
-
-      // walk up the directory, to make sure all the nodes are in place for
-      // directories above you.
-      $t_directory = $directory;
-      while ($t_directory != DIRECTORY_SEPARATOR) {
-        // move once up the path name
-        $t_directory = dirname($t_directory);
-        $t_directoryEntry = $dirMap->get($t_directory);
-        if (!$t_directoryEntry instanceof Directory) {
-          $t_directoryEntry = new Directory($t_directory);
-          $dirMap->set($t_directory, $t_directoryEntry);
-        }
-
-      }
-
+      $this->getDirectory($dirMap, dirname($fileName))
+        ->addFileFullPath($fileName);
     }
 
-    foreach ($dirMap as $directory => $directoryEntry) {
-
-      // Look for direct descendents.
-      foreach ($dirMap as $childDirectory => $childDirectoryEntry) {
-
-        if ($this->isChildOfDirectory($directory, $childDirectory) === true) {
-
-          $directoryEntry->addAlreadyCreatedDirectory($childDirectoryEntry);
-
-        }
-
-      }
-
-    }
-
-    self::$_root = $root;
-
-    return self::$_root;
+    return $root;
 
   }
 
-  private function isChildOfDirectory(
+  // --
+  // Returns the entry for the directory, creating it and any missing
+  // directories above it. A new entry is attached to its parent straight
+  // away, so children keep the order they were first seen in.
+  // --
+  private function getDirectory(
+    Map<string, Directory> $dirMap,
     string $directory,
-    string $childDirectory,
-  ): bool {
+  ): Directory {
 
-    if ($directory == $childDirectory) {
-      return false;
-    }
-
-    $offset = strpos($childDirectory, $directory);
+    $directoryEntry = $dirMap->get($directory);
 
-    // has to lead in with this with this directory
-    if ($offset !== false && $offset == 0) {
+    if ($directoryEntry instanceof Directory) {
+      return $directoryEntry;
+    }
 
-      // only allow 1 leaf deeper.
-      $extractedParent = dirname($childDirectory);
+    $directoryEntry = new Directory($directory);
+    $dirMap->set($directory, $directoryEntry);
 
-      if ($extractedParent == $directory) {
-        return true;
-      }
+    $parentDirectory = dirname($directory);
 
+    // dirname() of the top most directory is the directory itself.
+    if ($parentDirectory != $directory) {
+      $this->getDirectory($dirMap, $parentDirectory)
+        ->addAlreadyCreatedDirectory($directoryEntry);
     }
 
-    return false;
+    return $directoryEntry;
 
   }
 
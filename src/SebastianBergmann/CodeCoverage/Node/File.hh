@@ -123,7 +123,7 @@ class File extends AbstractNode {
    */
   public function getLinesOfCode(): Map<string, int> {
     $processedFile = $this->processedFile();
-    return $processedFile->stream()->getLinesOfCode();
+    return $processedFile->getLinesOfCode();
   }
 
   /**
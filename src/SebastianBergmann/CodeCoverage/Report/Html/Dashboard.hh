@@ -30,7 +30,11 @@ class Dashboard extends Renderer {
     $classes = $node->getClassesAndTraits();
 
     $template =
-      TemplateFactory::get($this->templatePath.'dashboard.html', '{{', '}}');
+      TemplateFactory::getCompiled(
+        $this->templatePath.'dashboard.html',
+        '{{',
+        '}}',
+      );
 
     $templateVariables = $this->getCommonTemplateVariables($node);
     $templateVariablesMap = $templateVariables->asMap();
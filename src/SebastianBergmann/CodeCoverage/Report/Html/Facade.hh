@@ -13,9 +13,14 @@ namespace SebastianBergmann\CodeCoverage\Report\Html;
 
 use SebastianBergmann\CodeCoverage\CodeCoverage;
 use SebastianBergmann\CodeCoverage\Node\Directory as NodeDirectory;
+use SebastianBergmann\CodeCoverage\Node\File as NodeFile;
 use SebastianBergmann\CodeCoverage\Report\Html\Dashboard;
+use SebastianBergmann\CodeCoverage\Report\Html\PageManifest;
 use SebastianBergmann\CodeCoverage\Report\Html\Renderer\Directory;
 use SebastianBergmann\CodeCoverage\Report\Html\Renderer\File;
+use Zynga\PHPUnit\V2\Version;
+
+use \Exception;
 use \RuntimeException;
 
 /**
@@ -42,6 +47,11 @@ class Facade {
    */
   private int $highLowerBound;
 
+  /**
+   * @var int
+   */
+  private int $workers;
+
   /**
    * Constructor.
    *
@@ -58,6 +68,23 @@ class Facade {
     $this->highLowerBound = $highLowerBound;
     $this->lowUpperBound = $lowUpperBound;
     $this->templatePath = __DIR__.'/Renderer/Template/';
+    $this->workers = 1;
+  }
+
+  /**
+   * Renders the pages below the root across this many forked workers.
+   *
+   * @param int $workers
+   */
+  public function setWorkers(int $workers): void {
+    $this->workers = max(1, $workers);
+  }
+
+  public static function isParallelSupported(): bool {
+    if (function_exists('pcntl_fork') && function_exists('pcntl_waitpid')) {
+      return true;
+    }
+    return false;
   }
 
   /**
@@ -142,16 +169,18 @@ class Facade {
     $root->getNumClassesAndTraits(true);
     //echo date('r')." - getRecursiveNumClassesAndTraits - complete\n";
 
-    // First render ourselves.
-    //echo date('r')." - render index.html - start\n";
-    $directory->render($root, $target.'index.html');
-    //echo date('r')." - render index.html - complete\n";
+    // Pages left unchanged since the last run into this directory are kept.
+    $manifest = new PageManifest($target, $this->_getManifestContext());
+    $manifest->load();
 
-    //echo date('r')." - render dashboard.html - start\n";
-    $dashboard->render($root, $target.'dashboard.html');
-    //echo date('r')." - render dashboard.html - complete\n";
-
-    $this->_renderDirectory($target, $root, $directory, $dashboard, $file);
+    $this->_renderDirectory(
+      $target,
+      $root,
+      $directory,
+      $dashboard,
+      $file,
+      $manifest,
+    );
 
     $this->copyFiles($target);
 
@@ -164,43 +193,180 @@ class Facade {
     return $currentPath.DIRECTORY_SEPARATOR.$newElems;
   }
 
+  // --
+  // Everything on a page apart from the node and the date, a change here
+  // invalidates every recorded fingerprint.
+  // --
+  private function _getManifestContext(): string {
+    return implode(
+      '|',
+      array(
+        Version::get(),
+        $this->generator,
+        $this->lowUpperBound,
+        $this->highLowerBound,
+        $this->templatePath,
+      ),
+    );
+  }
+
   private function _renderDirectory(
     string $target,
     NodeDirectory $root,
     Directory $directory,
     Dashboard $dashboard,
     File $file,
+    PageManifest $manifest,
   ): void {
 
-    foreach ($root->getDirectories() as $node) {
-
-      $id = $node->getId();
+    $directoryPages = Vector {};
+    $filePages = Vector {};
 
-      $renderDir = $this->_joinPath($target, $id);
-
-      if (!is_dir($renderDir)) {
-        mkdir($renderDir, 0755, true);
-      }
+    $this->_collectPages(
+      $target,
+      $root,
+      $directoryPages,
+      $filePages,
+      $manifest,
+    );
 
-      // Each directory is currently taking a hard second to render.
-      //echo date('r').' - render directory='.$renderDir.' - start'."\n";
-      $directory->render($node, $this->_joinPath($renderDir, 'index.html'));
-      //echo date('r').' - render directory='.$renderDir.' - complete'."\n";
+    $pages = $this->_stalePages($directoryPages, $filePages, $manifest);
 
-      //echo date('r').' - render dashboard='.$renderDir.' - start'."\n";
-      $dashboard->render(
-        $node,
-        $this->_joinPath($renderDir, 'dashboard.html'),
-      );
-      //echo date('r').' - render dashboard='.$renderDir.' - complete'."\n";
+    echo
+      date('r').
+      ' - CodeCoverage::render: '.
+      $pages->count().
+      ' of '.
+      ($directoryPages->count() + $filePages->count()).
+      " pages changed\n"
+    ;
 
-      $this->_renderDirectory(
-        $renderDir,
-        $node,
+    if ($this->workers <= 1 ||
+        $pages->count() <= 1 ||
+        self::isParallelSupported() !== true) {
+      $this->_renderPages(
+        $directoryPages,
+        $filePages,
+        $pages,
         $directory,
         $dashboard,
         $file,
       );
+      $manifest->save();
+      return;
+    }
+
+    $children = Map {};
+    $leftOver = Vector {};
+
+    // --
+    // Once the stats are in, the pages no longer depend on each other. Every
+    // worker inherits the finished coverage model and writes its share.
+    // --
+    foreach ($this->_partitionPages($directoryPages, $filePages, $pages) as
+             $share) {
+
+      $pid = pcntl_fork();
+
+      if ($pid == -1) {
+        // could not fork, this share is rendered here afterwards.
+        $leftOver->addAll($share);
+        continue;
+      }
+
+      if ($pid == 0) {
+
+        // anything the parent had buffered would otherwise be flushed twice.
+        while (ob_get_level() > 0) {
+          ob_end_clean();
+        }
+
+        $exitCode = 0;
+
+        try {
+          $this->_renderPages(
+            $directoryPages,
+            $filePages,
+            $share,
+            $directory,
+            $dashboard,
+            $file,
+          );
+        } catch (Exception $e) {
+          $exitCode = 1;
+        }
+
+        exit($exitCode);
+
+      }
+
+      $children->set($pid, $share);
+
+    }
+
+    foreach ($children as $pid => $share) {
+
+      $status = 0;
+      pcntl_waitpid($pid, $status);
+
+      if (!pcntl_wifexited($status) || pcntl_wexitstatus($status) != 0) {
+        // the worker did not make it, its pages are rendered here again.
+        $leftOver->addAll($share);
+      }
+
+    }
+
+    $this->_renderPages(
+      $directoryPages,
+      $filePages,
+      $leftOver,
+      $directory,
+      $dashboard,
+      $file,
+    );
+
+    $manifest->save();
+
+  }
+
+  // --
+  // Walks the tree once, creating the output directories and noting the
+  // page every node renders to along with its fingerprint. Directory pages
+  // are numbered first, file pages follow on. Returns the fingerprint of the
+  // given directory.
+  // --
+  private function _collectPages(
+    string $renderDir,
+    NodeDirectory $root,
+    Vector<(NodeDirectory, string, string)> $directoryPages,
+    Vector<(NodeFile, string, string)> $filePages,
+    PageManifest $manifest,
+  ): string {
+
+    $page = $directoryPages->count();
+    $directoryPages->add(tuple($root, $renderDir, ''));
+
+    $fingerprints = Vector {};
+
+    foreach ($root->getDirectories() as $node) {
+
+      $id = $node->getId();
+
+      $childDir = $this->_joinPath($renderDir, $id);
+
+      if (!is_dir($childDir)) {
+        mkdir($childDir, 0755, true);
+      }
+
+      $fingerprints->add(
+        $this->_collectPages(
+          $childDir,
+          $node,
+          $directoryPages,
+          $filePages,
+          $manifest,
+        ),
+      );
 
     }
 
@@ -208,20 +374,178 @@ class Facade {
 
       $id = $node->getId();
 
-      $renderDir = $this->_joinPath($target, $id);
+      $renderFile = $this->_joinPath($renderDir, $id);
 
-      $dir = dirname($renderDir);
+      $dir = dirname($renderFile);
 
       if (!is_dir($dir)) {
         mkdir($dir, 0755, true);
       }
 
-      $file->render($node, $renderDir.'.html');
+      $fingerprint = $manifest->fingerprintFile($node);
+
+      $filePages->add(tuple($node, $renderFile.'.html', $fingerprint));
+      $fingerprints->add($fingerprint);
+
+    }
+
+    $fingerprint = $manifest->fingerprintDirectory($root, $fingerprints);
+
+    $directoryPages[$page] = tuple($root, $renderDir, $fingerprint);
+
+    return $fingerprint;
+
+  }
+
+  private function _stalePages(
+    Vector<(NodeDirectory, string, string)> $directoryPages,
+    Vector<(NodeFile, string, string)> $filePages,
+    PageManifest $manifest,
+  ): Vector<int> {
+
+    $pages = Vector {};
+
+    foreach ($directoryPages as $page => $entry) {
+
+      list($node, $renderDir, $fingerprint) = $entry;
+
+      // both are looked at so both end up in the manifest.
+      $isIndexFresh = $manifest->isFresh(
+        $this->_joinPath($renderDir, 'index.html'),
+        $fingerprint,
+      );
+
+      $isDashboardFresh = $manifest->isFresh(
+        $this->_joinPath($renderDir, 'dashboard.html'),
+        $fingerprint,
+      );
+
+      if ($isIndexFresh !== true || $isDashboardFresh !== true) {
+        $pages->add($page);
+      }
+
+    }
+
+    $directoryCount = $directoryPages->count();
+
+    foreach ($filePages as $page => $entry) {
+
+      list($node, $renderFile, $fingerprint) = $entry;
+
+      if ($manifest->isFresh($renderFile, $fingerprint) !== true) {
+        $pages->add($directoryCount + $page);
+      }
+
+    }
+
+    return $pages;
+
+  }
+
+  private function _renderPages(
+    Vector<(NodeDirectory, string, string)> $directoryPages,
+    Vector<(NodeFile, string, string)> $filePages,
+    Vector<int> $pages,
+    Directory $directory,
+    Dashboard $dashboard,
+    File $file,
+  ): void {
+
+    $directoryCount = $directoryPages->count();
+
+    foreach ($pages as $page) {
+
+      if ($page < $directoryCount) {
+
+        list($node, $renderDir, $fingerprint) = $directoryPages[$page];
+
+        // Each directory is currently taking a hard second to render.
+        $directory->render($node, $this->_joinPath($renderDir, 'index.html'));
+
+        $dashboard->render(
+          $node,
+          $this->_joinPath($renderDir, 'dashboard.html'),
+        );
+
+        continue;
+
+      }
+
+      list($node, $renderFile, $fingerprint) =
+        $filePages[$page - $directoryCount];
+
+      $file->render($node, $renderFile);
 
     }
 
   }
 
+  // --
+  // Longest processing time first over source size: a file page costs about
+  // as much as its source is long, a directory page as much as the files it
+  // lists.
+  // --
+  private function _partitionPages(
+    Vector<(NodeDirectory, string, string)> $directoryPages,
+    Vector<(NodeFile, string, string)> $filePages,
+    Vector<int> $pages,
+  ): Vector<Vector<int>> {
+
+    $weights = array();
+
+    $directoryCount = $directoryPages->count();
+
+    foreach ($pages as $page) {
+
+      if ($page < $directoryCount) {
+        $weight = 1;
+        foreach ($directoryPages[$page][0]->getFiles() as $node) {
+          $weight += $this->_getSourceSize($node);
+        }
+        $weights[$page] = $weight;
+        continue;
+      }
+
+      $node = $filePages[$page - $directoryCount][0];
+
+      $weights[$page] = 1 + $this->_getSourceSize($node);
+
+    }
+
+    arsort($weights);
+
+    $workerCount = min($this->workers, count($weights));
+
+    $shares = Vector {};
+    $loads = Vector {};
+    for ($i = 0; $i < $workerCount; $i++) {
+      $shares->add(Vector {});
+      $loads->add(0);
+    }
+
+    foreach ($weights as $page => $weight) {
+      $lightest = 0;
+      for ($i = 1; $i < $workerCount; $i++) {
+        if ($loads[$i] < $loads[$lightest]) {
+          $lightest = $i;
+        }
+      }
+      $shares[$lightest]->add($page);
+      $loads[$lightest] = $loads[$lightest] + $weight;
+    }
+
+    return $shares;
+
+  }
+
+  private function _getSourceSize(NodeFile $node): int {
+    $path = $node->getPath();
+    if (!is_string($path) || !is_file($path)) {
+      return 0;
+    }
+    return intval(filesize($path));
+  }
+
   private function _needsTemplateCopy(string $target): bool {
 
     $destVersionFile = $target.'/version.txt';
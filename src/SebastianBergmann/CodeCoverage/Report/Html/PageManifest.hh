@@ -0,0 +1,164 @@
+<?hh // strict
+
+namespace SebastianBergmann\CodeCoverage\Report\Html;
+
+use SebastianBergmann\CodeCoverage\Node\Directory as DirectoryNode;
+use SebastianBergmann\CodeCoverage\Node\File as FileNode;
+
+/**
+ * The fingerprint every page of an html report was last rendered from, kept
+ * next to the pages in the report directory.
+ *
+ * A file page is fingerprinted from its source, its line states and its
+ * stats, a directory's index and dashboard from the fingerprints of
+ * everything below it. A page whose fingerprint matches the recorded one and
+ * that is still on disk does not need rendering again, it only keeps the
+ * generation date of the run that wrote it.
+ */
+class PageManifest {
+  const string FORMAT_VERSION = '1';
+  const string MANIFEST_FILE = 'pages.manifest';
+
+  /**
+   * @var string
+   */
+  private string $target;
+
+  /**
+   * @var string
+   */
+  private string $context;
+
+  /**
+   * page path => fingerprint it was rendered from
+   */
+  private Map<string, string> $recorded;
+
+  /**
+   * page path => fingerprint of this run
+   */
+  private Map<string, string> $current;
+
+  /**
+   * @param string $target  the report directory, with a trailing separator
+   * @param string $context whatever else ends up on every page: generator,
+   *                        version and bounds
+   */
+  public function __construct(string $target, string $context) {
+    $this->target = $target;
+    $this->context = $context;
+    $this->recorded = Map {};
+    $this->current = Map {};
+  }
+
+  public function getManifestFile(): string {
+    return $this->target.self::MANIFEST_FILE;
+  }
+
+  public function load(): bool {
+
+    $manifestFile = $this->getManifestFile();
+
+    if (!is_file($manifestFile)) {
+      return false;
+    }
+
+    $payload = file_get_contents($manifestFile);
+
+    if (!is_string($payload) || $payload == '') {
+      return false;
+    }
+
+    $data = unserialize($payload);
+
+    if (!is_array($data) ||
+        !array_key_exists('version', $data) ||
+        $data['version'] !== self::FORMAT_VERSION ||
+        !array_key_exists('context', $data) ||
+        $data['context'] !== $this->context ||
+        !array_key_exists('pages', $data) ||
+        !is_array($data['pages'])) {
+      return false;
+    }
+
+    foreach ($data['pages'] as $page => $fingerprint) {
+      $this->recorded->set(strval($page), strval($fingerprint));
+    }
+
+    return true;
+
+  }
+
+  public function fingerprintFile(FileNode $node): string {
+
+    $buffer = strval($node->getPath())."\n";
+    $buffer .= md5($node->processedFile()->source()->get())."\n";
+
+    foreach ($node->getCoverageData() as $lineNo => $lineState) {
+      $buffer .= $lineNo.':'.$lineState.',';
+    }
+
+    $buffer .= "\n".implode(
+      ',',
+      array(
+        $node->getNumClassesAndTraits(),
+        $node->getNumTestedClassesAndTraits(),
+        $node->getNumMethods(),
+        $node->getNumTestedMethods(),
+        $node->getNumExecutableLines(),
+        $node->getNumExecutedLines(),
+      ),
+    );
+
+    return md5($buffer);
+
+  }
+
+  /**
+   * @param Vector<string> $fingerprints those of the directories and files
+   *                                     directly below the node
+   */
+  public function fingerprintDirectory(
+    DirectoryNode $node,
+    Vector<string> $fingerprints,
+  ): string {
+    return md5(strval($node->getPath())."\n".implode(',', $fingerprints));
+  }
+
+  /**
+   * Notes the fingerprint for the page and tells whether the page on disk was
+   * rendered from the same one.
+   */
+  public function isFresh(string $page, string $fingerprint): bool {
+
+    $this->current->set($page, $fingerprint);
+
+    if ($this->recorded->get($page) !== $fingerprint) {
+      return false;
+    }
+
+    return is_file($page);
+
+  }
+
+  public function save(): bool {
+
+    $data = array(
+      'version' => self::FORMAT_VERSION,
+      'context' => $this->context,
+      'pages' => $this->current->toArray(),
+    );
+
+    $manifestFile = $this->getManifestFile();
+
+    $tmpFile = $manifestFile.'.'.getmypid().'.tmp';
+
+    if (file_put_contents($tmpFile, serialize($data)) === false) {
+      return false;
+    }
+
+    return rename($tmpFile, $manifestFile);
+
+  }
+
+}
@@ -31,7 +31,11 @@ class Directory extends Renderer {
   public function render(DirectoryNode $node, string $file): void {
 
     $template =
-      TemplateFactory::get($this->templatePath.'directory.html', '{{', '}}');
+      TemplateFactory::getCompiled(
+        $this->templatePath.'directory.html',
+        '{{',
+        '}}',
+      );
 
     $templateVariables = $this->getCommonTemplateVariables($node);
     $templateVariableMap = $templateVariables->asMap();
@@ -42,9 +42,7 @@ use SebastianBergmann\TokenStream\Tokens\PHP_Token_Try;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_While;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Variable;
 use SebastianBergmann\TokenStream\Token\Types;
-use
-  SebastianBergmann\CodeCoverage\Report\Html\Renderer\SourcreFileLineBuffer
-;
+use SebastianBergmann\CodeCoverage\Report\Html\Renderer\PageWriter;
 
 use Zynga\CodeBase\V1\FileFactory;
 use Zynga\CodeBase\V1\Code\Code_Class;
@@ -114,12 +112,21 @@ class File extends Renderer {
 
     $templateVariables = $this->getCommonTemplateVariables($node);
 
-    CodeFile::renderTo(
-      $file,
-      $templateVariables,
-      $this->renderItems($node),
-      $this->renderSource($node),
-    );
+    // --
+    // The rows go out as they are rendered, generated files run to tens of
+    // thousands of lines and the page would otherwise sit in memory whole.
+    // --
+    $writer = new PageWriter($file);
+
+    try {
+      $writer->write(
+        CodeFile::renderHead($templateVariables, $this->renderItems($node)),
+      );
+      $this->renderSource($node, $writer);
+      $writer->write(CodeFile::renderTail($templateVariables));
+    } finally {
+      $writer->close();
+    }
 
   }
 
@@ -315,16 +322,16 @@ class File extends Renderer {
   const DEBUG_TOKENS = false;
 
   /**
-   * @param FileNode $node
-   *
-   * @return string
+   * @param FileNode   $node
+   * @param PageWriter $writer
    */
-  protected function renderSource(FileNode $node): string {
+  protected function renderSource(FileNode $node, PageWriter $writer): void {
 
     $fileName = $node->getPath();
 
     if (!is_string($fileName)) {
-      return 'invalid fileName provided';
+      $writer->write('invalid fileName provided');
+      return;
     }
 
     $coverageData = $node->getCoverageData();
@@ -333,8 +340,6 @@ class File extends Renderer {
 
     $processedFile = FileFactory::get($fileName);
 
-    $lines = '';
-
     $lineNo = 0;
 
     foreach ($codeLines as $codeLine) {
@@ -369,13 +374,15 @@ class File extends Renderer {
           '<span class="string">!!We do not support code coverage ignore.!!</span>';
       }
 
-      $lines .= CodeRow::render(
-        $lineNo,
-        $trClass,
-        $popover,
-        $lineStateCss,
-        $lineState,
-        $codeLine,
+      $writer->write(
+        CodeRow::render(
+          $lineNo,
+          $trClass,
+          $popover,
+          $lineStateCss,
+          $lineState,
+          $codeLine,
+        ),
       );
 
       // if we are debugging tokens and what it means for the rendering.
@@ -444,7 +451,7 @@ class File extends Renderer {
 
         }
 
-        $lines .= CodeTokens::render('Tokens', $lineNo, $tokensForLine);
+        $writer->write(CodeTokens::render('Tokens', $lineNo, $tokensForLine));
 
         // Executable ranges need debugging at times.
         $execRanges =
@@ -464,9 +471,9 @@ class File extends Renderer {
               $range->getEnd().
               ']';
           }
-          $lines .= CodeTokens::render('ExecRanges', $lineNo, $data);
+          $writer->write(CodeTokens::render('ExecRanges', $lineNo, $data));
         } else {
-          $lines .= CodeTokens::render('ExecRanges', $lineNo, '-NONE-');
+          $writer->write(CodeTokens::render('ExecRanges', $lineNo, '-NONE-'));
         }
 
       }
@@ -575,15 +582,16 @@ class File extends Renderer {
     //   $i++;
     // }
 
-    return $lines;
   }
 
   /**
+   * Yields the highlighted source one line at a time.
+   *
    * @param string $file
    *
-   * @return array
+   * @return Generator
    */
-  protected function loadFile(string $file): array<string> {
+  protected function loadFile(string $file): Generator<int, string, void> {
 
     if (FileFactory::isFileRegistered($file) !== true) {
       error_log(
@@ -594,53 +602,56 @@ class File extends Renderer {
     $processedFile = FileFactory::get($file);
 
     $buffer = $processedFile->source()->get();
-    //$tokens = $processedFile->rawTokens()->get();
-    $tokens = $processedFile->stream()->tokens();
 
-    $result = new SourceFileLineBuffer();
+    // text and type are all that is needed here, read them off the columns
+    // rather than building every token object.
+    $columns = $processedFile->stream()->columns();
+    $tokenCount = $columns->count();
 
-    $i = 0;
+    $line = '';
     $stringFlag = false;
 
-    foreach ($tokens as $j => $token) {
+    for ($j = 0; $j < $tokenCount; $j++) {
 
-      $value = $token->getText();
+      $value = $columns->getText($buffer, $j);
 
       $value = htmlspecialchars($value, $this->htmlspecialcharsFlags);
 
       if ($value === "\n") {
-        $result->set(++$i, '');
+        yield $line;
+        $line = '';
       } else {
 
         $lines = explode("\n", $value);
 
         $lineCount = count($lines);
-        foreach ($lines as $jj => $line) {
-          // $line = trim($line);
+        foreach ($lines as $jj => $part) {
+          // $part = trim($part);
 
-          if ($line !== '') {
+          if ($part !== '') {
             if ($stringFlag) {
               $colour = 'string';
             } else {
-              $colour = $token->getTokenType();
+              $colour = $columns->getTokenType($j);
             }
 
             //if ($colour == 'default') {
-            //  $line = $token.$line;
+            //  $part = $token.$part;
             //}
 
-            $result->appendTo($i, CodeLine::render($colour, $line));
+            $line .= CodeLine::render($colour, $part);
 
           }
 
           if (($jj + 1) < $lineCount) {
-            $result->set(++$i, '');
+            yield $line;
+            $line = '';
           }
         }
       }
     }
 
-    return $result->get();
+    yield $line;
 
   }
 
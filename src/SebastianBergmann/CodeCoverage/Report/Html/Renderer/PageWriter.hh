@@ -0,0 +1,74 @@
+<?hh // strict
+
+namespace SebastianBergmann\CodeCoverage\Report\Html\Renderer;
+
+use \RuntimeException;
+
+// --
+// Writes a page out as it is rendered rather than building it whole first.
+//
+// Whatever is written is gathered into a buffer that goes to the file each
+// time it grows past BUFFER_SIZE, so a page only ever holds about that much
+// of itself in memory however long the source it shows.
+// --
+class PageWriter {
+  const int BUFFER_SIZE = 65536;
+
+  private string $_target;
+  private resource $_handle;
+  private string $_buffer;
+
+  public function __construct(string $target) {
+
+    $handle = @fopen($target, 'wt');
+
+    if (!is_resource($handle)) {
+
+      $error = error_get_last();
+
+      throw new RuntimeException(
+        sprintf(
+          'Could not write to %s: %s',
+          $target,
+          substr($error['message'], strpos($error['message'], ':') + 2),
+        ),
+      );
+
+    }
+
+    $this->_target = $target;
+    $this->_handle = $handle;
+    $this->_buffer = '';
+
+  }
+
+  public function write(string $value): void {
+
+    $this->_buffer .= $value;
+
+    if (strlen($this->_buffer) >= self::BUFFER_SIZE) {
+      $this->flush();
+    }
+
+  }
+
+  public function flush(): void {
+
+    if ($this->_buffer === '') {
+      return;
+    }
+
+    if (fwrite($this->_handle, $this->_buffer) === false) {
+      throw new RuntimeException('Could not write to '.$this->_target);
+    }
+
+    $this->_buffer = '';
+
+  }
+
+  public function close(): void {
+    $this->flush();
+    fclose($this->_handle);
+  }
+
+}
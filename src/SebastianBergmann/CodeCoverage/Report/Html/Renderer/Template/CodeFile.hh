@@ -24,6 +24,17 @@ class CodeFile {
     CommonTemplateVariables $common,
     string $items,
     string $lines,
+  ): string {
+    return self::renderHead($common, $items).$lines.self::renderTail($common);
+  }
+
+  // --
+  // Everything up to the first code row, renderTail() picks up after the
+  // last one, so the rows can be written out in between as they come.
+  // --
+  public static function renderHead(
+    CommonTemplateVariables $common,
+    string $items,
   ): string {
     $buffer = '';
     $buffer .= '<!DOCTYPE html>';
@@ -83,7 +94,11 @@ class CodeFile {
     $buffer .=
       '<table id="code" class="table table-borderless table-condensed">';
     $buffer .= '<tbody>';
-    $buffer .= $lines;
+    return $buffer;
+  }
+
+  public static function renderTail(CommonTemplateVariables $common): string {
+    $buffer = '';
     $buffer .= '</tbody>';
     $buffer .= '</table>';
     $buffer .= '<footer>';
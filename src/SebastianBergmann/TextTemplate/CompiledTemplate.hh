@@ -0,0 +1,168 @@
+<?hh // strict
+
+namespace SebastianBergmann\TextTemplate;
+
+use \RuntimeException;
+
+/**
+ * A template split once into literal segments and the placeholder slots
+ * between them.
+ *
+ * Rendering walks the two in order and never scans the template again,
+ * unlike Template::render(), which runs str_replace() over the whole body for
+ * every render. A placeholder no value is given for is rendered as written,
+ * and values are never searched for placeholders themselves.
+ */
+class CompiledTemplate {
+  /**
+   * @var ImmVector<string> one more than there are slots
+   */
+  private ImmVector<string> $segments;
+
+  /**
+   * @var ImmVector<string> the key of every placeholder in template order
+   */
+  private ImmVector<string> $slots;
+
+  private string $openDelimiter;
+  private string $closeDelimiter;
+
+  public function __construct(
+    string $template,
+    string $openDelimiter = '{',
+    string $closeDelimiter = '}',
+  ) {
+
+    $this->openDelimiter = $openDelimiter;
+    $this->closeDelimiter = $closeDelimiter;
+
+    $segments = Vector {};
+    $slots = Vector {};
+
+    $openLength = strlen($openDelimiter);
+    $closeLength = strlen($closeDelimiter);
+
+    $length = strlen($template);
+    $offset = 0;
+
+    while (true) {
+
+      $open = strpos($template, $openDelimiter, $offset);
+
+      if ($open === false) {
+        break;
+      }
+
+      $close = strpos($template, $closeDelimiter, $open + $openLength);
+
+      if ($close === false) {
+        break;
+      }
+
+      // the key starts after the last open delimiter before the close.
+      $keyStart = $open + $openLength;
+      $inner = strrpos(
+        substr($template, $keyStart, $close - $keyStart),
+        $openDelimiter,
+      );
+      if ($inner !== false) {
+        $open = $keyStart + $inner;
+        $keyStart = $open + $openLength;
+      }
+
+      $segments->add(substr($template, $offset, $open - $offset));
+      $slots->add(substr($template, $keyStart, $close - $keyStart));
+
+      $offset = $close + $closeLength;
+
+    }
+
+    if ($offset < $length) {
+      $segments->add(substr($template, $offset));
+    } else {
+      $segments->add('');
+    }
+
+    $this->segments = $segments->toImmVector();
+    $this->slots = $slots->toImmVector();
+
+  }
+
+  public function getSegments(): ImmVector<string> {
+    return $this->segments;
+  }
+
+  public function getSlots(): ImmVector<string> {
+    return $this->slots;
+  }
+
+  /**
+   * Renders the template and returns the result.
+   *
+   * @return string
+   */
+  public function render(
+    Map<string, mixed> $values,
+    bool $trimTemplate = false,
+  ): string {
+
+    $rendered = $this->segments[0];
+
+    foreach ($this->slots as $slot => $key) {
+      $rendered .= $this->getValue($values, $key);
+      $rendered .= $this->segments[$slot + 1];
+    }
+
+    if ($trimTemplate === true) {
+      return trim($rendered);
+    }
+
+    return $rendered;
+
+  }
+
+  /**
+   * Renders the template straight into a file.
+   *
+   * @param string $target
+   */
+  public function renderTo(string $target, Map<string, mixed> $values): void {
+
+    $fp = @fopen($target, 'wt');
+
+    if (!is_resource($fp)) {
+
+      $error = error_get_last();
+
+      throw new RuntimeException(
+        sprintf(
+          'Could not write to %s: %s',
+          $target,
+          substr($error['message'], strpos($error['message'], ':') + 2),
+        ),
+      );
+
+    }
+
+    fwrite($fp, $this->segments[0]);
+
+    foreach ($this->slots as $slot => $key) {
+      fwrite($fp, $this->getValue($values, $key));
+      fwrite($fp, $this->segments[$slot + 1]);
+    }
+
+    fclose($fp);
+
+  }
+
+  private function getValue(Map<string, mixed> $values, string $key): string {
+
+    if (!$values->containsKey($key)) {
+      return $this->openDelimiter.$key.$this->closeDelimiter;
+    }
+
+    return strval($values[$key]);
+
+  }
+
+}
@@ -71,6 +71,10 @@ class Template {
     }
   }
 
+  public function getTemplate(): string {
+    return $this->template;
+  }
+
   public function setOpenDelimiter(string $delim): void {
     $this->openDelimiter = $delim;
   }
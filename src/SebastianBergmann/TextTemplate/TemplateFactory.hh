@@ -2,11 +2,15 @@
 
 namespace SebastianBergmann\TextTemplate;
 
+use SebastianBergmann\TextTemplate\CompiledTemplate;
 use SebastianBergmann\TextTemplate\Template;
 
 class TemplateFactory {
   static private Map<string, Template> $templates = Map {};
 
+  // keyed by delimiters and filename, as both decide how it splits.
+  static private Map<string, CompiledTemplate> $compiled = Map {};
+
   static public function get(
     string $filename,
     string $openDelimiter,
@@ -29,4 +33,36 @@ class TemplateFactory {
 
   }
 
+  // --
+  // Loads and splits the template the first time it is asked for, every
+  // later render reuses the same segments.
+  // --
+  static public function getCompiled(
+    string $filename,
+    string $openDelimiter,
+    string $closeDelimiter,
+  ): CompiledTemplate {
+
+    $key = $openDelimiter.$closeDelimiter.$filename;
+
+    $compiled = self::$compiled->get($key);
+
+    if ($compiled instanceof CompiledTemplate) {
+      return $compiled;
+    }
+
+    $template = self::get($filename, $openDelimiter, $closeDelimiter);
+
+    $compiled = new CompiledTemplate(
+      $template->getTemplate(),
+      $openDelimiter,
+      $closeDelimiter,
+    );
+
+    self::$compiled->set($key, $compiled);
+
+    return $compiled;
+
+  }
+
 }
@@ -12,6 +12,8 @@ namespace SebastianBergmann\TokenStream\Token;
  */
 
 use SebastianBergmann\TokenStream\TokenInterface;
+use SebastianBergmann\TokenStream\Token\Stream\BlockIndex;
+use SebastianBergmann\TokenStream\Token\Stream\TokenColumns;
 use Zynga\CodeBase\V1\File;
 
 use \Exception;
@@ -30,6 +32,16 @@ class Stream {
   // Map of lineNumber to tokens on that line.
   private Map<int, Vector<TokenInterface>> $_lineToTokens = Map {};
 
+  // Curly / semicolon boundaries, maintained as tokens are added.
+  private BlockIndex $_blockIndex;
+
+  // Id / line / text / type of every token, maintained as tokens are added.
+  private TokenColumns $_columns;
+
+  // When compact only the columns are held, token objects get rebuilt from
+  // them the next time something asks for them.
+  private bool $_isCompact = false;
+
   /**
    * @var int
    */
@@ -54,6 +66,8 @@ class Stream {
   public function __construct(File $parent) {
 
     $this->_parent = $parent;
+    $this->_blockIndex = new BlockIndex();
+    $this->_columns = new TokenColumns();
 
   }
 
@@ -61,14 +75,78 @@ class Stream {
     return $this->_parent;
   }
 
+  public function blockIndex(): BlockIndex {
+    return $this->_blockIndex;
+  }
+
+  public function columns(): TokenColumns {
+    return $this->_columns;
+  }
+
   public function get(int $offset): ?TokenInterface {
+    if ($this->_isCompact === true) {
+      // a one off view, not worth rebuilding every token for.
+      return $this->_columns->materialize(
+        $this->_parent,
+        $this->_parent->source()->get(),
+        $offset,
+      );
+    }
     return $this->tokens->get($offset);
   }
 
+  public function isCompact(): bool {
+    return $this->_isCompact;
+  }
+
+  // --
+  // Releases the token objects and the line to token map, keeping only the
+  // columns, the block index and the totals computed during the scan.
+  // --
+  public function compact(): void {
+
+    if ($this->_isCompact === true) {
+      return;
+    }
+
+    // only streams that were scanned have columns to fall back on.
+    if ($this->_columns->count() != $this->tokens->count()) {
+      return;
+    }
+
+    $this->tokens = Vector {};
+    $this->_lineToTokens = Map {};
+    $this->_isCompact = true;
+
+  }
+
+  private function expand(): void {
+
+    if ($this->_isCompact !== true) {
+      return;
+    }
+
+    $this->_isCompact = false;
+
+    $source = $this->_parent->source()->get();
+    $tokenCount = $this->_columns->count();
+
+    for ($position = 0; $position < $tokenCount; $position++) {
+      $token = $this->_columns->materialize($this->_parent, $source, $position);
+      if ($token instanceof TokenInterface) {
+        $this->tokens->add($token);
+        $this->addTokenToLine($token);
+      }
+    }
+
+  }
+
   /**
    * @return string
    */
   public function __toString(): string {
+    $this->expand();
+
     $buffer = '';
 
     foreach ($this->tokens as $token) {
@@ -93,6 +171,9 @@ class Stream {
    * @return int
    */
   public function count(): int {
+    if ($this->_isCompact === true) {
+      return $this->_columns->count();
+    }
     return $this->tokens->count();
   }
 
@@ -100,6 +181,7 @@ class Stream {
    * @return Vector<TokenInterface>[]
    */
   public function tokens(): Vector<TokenInterface> {
+    $this->expand();
     return $this->tokens;
   }
 
@@ -129,6 +211,7 @@ class Stream {
    * @return bool
    */
   public function valid(): bool {
+    $this->expand();
     return $this->tokens->containsKey($this->position);
   }
 
@@ -143,6 +226,7 @@ class Stream {
    * @return PHP_Token
    */
   public function current(): ?TokenInterface {
+    $this->expand();
     return $this->tokens->get($this->position);
   }
 
@@ -158,6 +242,7 @@ class Stream {
    * @return bool
    */
   public function offsetExists(int $offset): bool {
+    $this->expand();
     return $this->tokens->containsKey($offset);
   }
 
@@ -169,6 +254,7 @@ class Stream {
    * @throws OutOfBoundsException
    */
   public function offsetGet(int $offset): TokenInterface {
+    $this->expand();
     $token = $this->tokens->get($offset);
     if (!$token instanceof TokenInterface) {
       throw new OutOfBoundsException(
@@ -178,8 +264,16 @@ class Stream {
     return $token;
   }
 
-  public function addToken(TokenInterface $token): bool {
+  public function addToken(
+    TokenInterface $token,
+    int $sourceOffset = -1,
+  ): bool {
+    $this->expand();
     $this->tokens->add($token);
+    $this->_blockIndex->add($token);
+    if ($sourceOffset >= 0) {
+      $this->_columns->add($token, $sourceOffset);
+    }
     $this->addTokenToLine($token);
     $lineNo = $token->getLine();
     if ($lineNo > $this->totalLineCount) {
@@ -214,6 +308,7 @@ class Stream {
   }
 
   public function getLineToTokens(int $lineNo): Vector<TokenInterface> {
+    $this->expand();
     $tokens = $this->_lineToTokens->get($lineNo);
 
     if ($tokens instanceof Vector) {
@@ -225,6 +320,7 @@ class Stream {
   }
 
   public function getLineToTokensForLine(): Map<int, Vector<TokenInterface>> {
+    $this->expand();
     return $this->_lineToTokens;
   }
 
@@ -235,6 +331,8 @@ class Stream {
    */
   public function offsetUnset(int $offset): void {
 
+    $this->expand();
+
     if (!$this->offsetExists($offset)) {
       throw new OutOfBoundsException(
         sprintf('No token at position "%s"', $offset),
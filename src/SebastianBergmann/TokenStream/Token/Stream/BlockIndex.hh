@@ -0,0 +1,179 @@
+<?hh // strict
+
+namespace SebastianBergmann\TokenStream\Token\Stream;
+
+use SebastianBergmann\TokenStream\TokenInterface;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Close_Curly;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Curly_Open;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Open_Curly;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Semicolon;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Whitespace;
+
+// --
+// Block boundaries for every position within a stream, built in the same pass
+// that adds the tokens to the stream.
+//
+// Each query takes a position within Stream::tokens() and answers with the
+// id of the first matching token found at or after that position, which is
+// exactly what the old forward scans within the tokens used to compute:
+//  - end of block: the close curly that brings the curly depth back to the
+//    depth the scan started at.
+//  - end of statement: the first semicolon at the depth the scan started at.
+//  - next open curly, next semicolon, next non whitespace token.
+//
+// Positions that have not found their match yet are parked in pending lists
+// and resolved as soon as the matching token is added, so the whole index is
+// O(n) in the number of tokens.
+// --
+class BlockIndex {
+  private int $_depth;
+
+  private Vector<int> $_endOfBlockIds;
+  private Vector<int> $_endOfStatementIds;
+  private Vector<int> $_nextOpenCurlyIds;
+  private Vector<int> $_nextSemicolonIds;
+  private Vector<int> $_nextNonWhitespaceIds;
+
+  private Map<int, Vector<int>> $_pendingEndOfBlock;
+  private Map<int, Vector<int>> $_pendingEndOfStatement;
+  private Vector<int> $_pendingOpenCurly;
+  private Vector<int> $_pendingSemicolon;
+  private Vector<int> $_pendingNonWhitespace;
+
+  public function __construct() {
+    $this->_depth = 0;
+
+    $this->_endOfBlockIds = Vector {};
+    $this->_endOfStatementIds = Vector {};
+    $this->_nextOpenCurlyIds = Vector {};
+    $this->_nextSemicolonIds = Vector {};
+    $this->_nextNonWhitespaceIds = Vector {};
+
+    $this->_pendingEndOfBlock = Map {};
+    $this->_pendingEndOfStatement = Map {};
+    $this->_pendingOpenCurly = Vector {};
+    $this->_pendingSemicolon = Vector {};
+    $this->_pendingNonWhitespace = Vector {};
+  }
+
+  public function add(TokenInterface $token): void {
+
+    $position = $this->_endOfBlockIds->count();
+
+    $this->_endOfBlockIds->add(-1);
+    $this->_endOfStatementIds->add(-1);
+    $this->_nextOpenCurlyIds->add(-1);
+    $this->_nextSemicolonIds->add(-1);
+    $this->_nextNonWhitespaceIds->add(-1);
+
+    // A scan starting at this position includes this token.
+    $this->park($this->_pendingEndOfBlock, $this->_depth, $position);
+    $this->park($this->_pendingEndOfStatement, $this->_depth, $position);
+    $this->_pendingOpenCurly->add($position);
+    $this->_pendingSemicolon->add($position);
+    $this->_pendingNonWhitespace->add($position);
+
+    $tokenId = $token->getId();
+
+    if ($token instanceof PHP_Token_Open_Curly) {
+      $this->_depth++;
+      $this->resolve(
+        $this->_nextOpenCurlyIds,
+        $this->_pendingOpenCurly,
+        $tokenId,
+      );
+    } else if ($token instanceof PHP_Token_Curly_Open) {
+      $this->_depth++;
+    } else if ($token instanceof PHP_Token_Close_Curly) {
+      $this->_depth--;
+      $pending = $this->_pendingEndOfBlock->get($this->_depth);
+      if ($pending instanceof Vector) {
+        $this->resolve($this->_endOfBlockIds, $pending, $tokenId);
+      }
+    } else if ($token instanceof PHP_Token_Semicolon) {
+      $pending = $this->_pendingEndOfStatement->get($this->_depth);
+      if ($pending instanceof Vector) {
+        $this->resolve($this->_endOfStatementIds, $pending, $tokenId);
+      }
+      $this->resolve(
+        $this->_nextSemicolonIds,
+        $this->_pendingSemicolon,
+        $tokenId,
+      );
+    }
+
+    if (!$token instanceof PHP_Token_Whitespace) {
+      $this->resolve(
+        $this->_nextNonWhitespaceIds,
+        $this->_pendingNonWhitespace,
+        $tokenId,
+      );
+    }
+
+  }
+
+  // --
+  // Anything still pending at the end of the stream has no match, release the
+  // pending lists as they are no longer needed.
+  // --
+  public function finish(): void {
+    $this->_pendingEndOfBlock->clear();
+    $this->_pendingEndOfStatement->clear();
+    $this->_pendingOpenCurly->clear();
+    $this->_pendingSemicolon->clear();
+    $this->_pendingNonWhitespace->clear();
+  }
+
+  public function getEndOfBlockId(int $position): int {
+    return $this->lookup($this->_endOfBlockIds, $position);
+  }
+
+  public function getEndOfStatementId(int $position): int {
+    return $this->lookup($this->_endOfStatementIds, $position);
+  }
+
+  public function getNextOpenCurlyId(int $position): int {
+    return $this->lookup($this->_nextOpenCurlyIds, $position);
+  }
+
+  public function getNextSemicolonId(int $position): int {
+    return $this->lookup($this->_nextSemicolonIds, $position);
+  }
+
+  public function getNextNonWhitespaceId(int $position): int {
+    return $this->lookup($this->_nextNonWhitespaceIds, $position);
+  }
+
+  private function lookup(Vector<int> $ids, int $position): int {
+    $id = $ids->get($position);
+    if ($id === null) {
+      return -1;
+    }
+    return $id;
+  }
+
+  private function park(
+    Map<int, Vector<int>> $pendingByDepth,
+    int $depth,
+    int $position,
+  ): void {
+    $pending = $pendingByDepth->get($depth);
+    if ($pending instanceof Vector) {
+      $pending->add($position);
+    } else {
+      $pendingByDepth->set($depth, Vector {$position});
+    }
+  }
+
+  private function resolve(
+    Vector<int> $ids,
+    Vector<int> $pending,
+    int $tokenId,
+  ): void {
+    foreach ($pending as $position) {
+      $ids->set($position, $tokenId);
+    }
+    $pending->clear();
+  }
+
+}
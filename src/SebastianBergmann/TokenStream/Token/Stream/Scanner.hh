@@ -13,7 +13,6 @@ use SebastianBergmann\TokenStream\Tokens\PHP_Token_Halt_Compiler;
 use SebastianBergmann\TokenStream\Token\CustomTokens;
 
 use Zynga\CodeBase\V1\File;
-use Zynga\CodeBase\V1\File\RawToken;
 
 use \Exception;
 
@@ -22,41 +21,49 @@ class Scanner {
   /**
    * Scans the source for sequences of characters and converts them into a
    * stream of tokens.
+   *
+   * The token_get_all() output is walked directly, each element becoming its
+   * final token without an intermediate raw token object.
    */
   public function scan(File $codeFile, Stream $stream): void {
 
-    if ($codeFile->source()->load() !== true ||
-        $codeFile->rawTokens()->load() !== true) {
+    if ($codeFile->source()->load() !== true) {
       return;
     }
 
     $sourceCode = $codeFile->source()->get();
-    $tokens = $codeFile->rawTokens()->get();
+    $rawTokens = token_get_all($sourceCode);
+
+    if (!is_array($rawTokens)) {
+      return;
+    }
 
     $id = 0;
     $line = 1;
 
-    $numTokens = $tokens->count();
+    // byte offset of the current token within the source, for the columns.
+    $sourceOffset = 0;
+
+    $numTokens = count($rawTokens);
 
     $lastNonWhitespaceTokenWasDoubleColon = false;
 
     for ($i = 0; $i < $numTokens; ++$i) {
 
-      $token = $tokens->get($i);
+      $rawToken = $rawTokens[$i];
 
       $newToken = null;
       $text = '';
+      $tokenId = -1;
       $skip = 0;
 
-      if (!$token instanceof RawToken) {
-        continue;
-      }
-
-      $text = $token->getText();
-      $tokenId = $token->getTokenId();
-
-      // first look up our custom tokens, as this is a unresolved token.
-      if ($token->getLineNo() == -1) {
+      if (is_array($rawToken)) {
+        $tokenId = (int) $rawToken[0];
+        $text = (string) $rawToken[1];
+      } else {
+        // first look up our custom tokens, as this is a unresolved token.
+        $text = (string) $rawToken;
+        $tokenId = CustomTokens::getTokenIdFromString($text);
 
         $t_tokenName = CustomTokens::getTokenClassNameFromId($tokenId);
 
@@ -87,8 +94,7 @@ class Scanner {
           $tokenClass = 'PHP_Token_Class_Name_Constant';
           $newToken = TokenFactory::createTokenFromName($tokenClass);
         } else if ($tokenId == T_USE &&
-                   $tokens->containsKey($i + 2) &&
-                   $tokens[$i + 2]->getTokenId() == T_FUNCTION) {
+                   $this->peekTokenId($rawTokens, $i + 2) == T_FUNCTION) {
           $tokenClass = 'PHP_Token_Use_Function';
           $newToken = TokenFactory::createTokenFromName($tokenClass);
           $skip = 2;
@@ -111,12 +117,17 @@ class Scanner {
 
       if ($newToken instanceof TokenInterface) {
         $newToken->setAllAttributes($text, $line, $codeFile, $id);
-        $stream->addToken($newToken);
+        $stream->addToken($newToken, $sourceOffset);
       }
 
       $lines = substr_count($text, "\n");
       $line += $lines;
 
+      $sourceOffset += strlen($text);
+      for ($skipped = 1; $skipped <= $skip; $skipped++) {
+        $sourceOffset += strlen($this->peekTokenText($rawTokens, $i + $skipped));
+      }
+
       if ($newToken instanceof PHP_Token_Halt_Compiler) {
         break;
       }
@@ -130,6 +141,40 @@ class Scanner {
       $i += $skip;
     }
 
+    $stream->blockIndex()->finish();
+
+  }
+
+  private function peekTokenId(array $rawTokens, int $offset): int {
+
+    if (!array_key_exists($offset, $rawTokens)) {
+      return -1;
+    }
+
+    $rawToken = $rawTokens[$offset];
+
+    if (is_array($rawToken)) {
+      return (int) $rawToken[0];
+    }
+
+    return CustomTokens::getTokenIdFromString((string) $rawToken);
+
+  }
+
+  private function peekTokenText(array $rawTokens, int $offset): string {
+
+    if (!array_key_exists($offset, $rawTokens)) {
+      return '';
+    }
+
+    $rawToken = $rawTokens[$offset];
+
+    if (is_array($rawToken)) {
+      return (string) $rawToken[1];
+    }
+
+    return (string) $rawToken;
+
   }
 
   private Map<int, string> $_tokenIdToShortName = Map {};
@@ -0,0 +1,154 @@
+<?hh // strict
+
+namespace SebastianBergmann\TokenStream\Token\Stream;
+
+use SebastianBergmann\TokenStream\TokenInterface;
+use SebastianBergmann\TokenStream\Token\Factory as TokenFactory;
+use Zynga\CodeBase\V1\File;
+
+// --
+// Column store for the tokens of a stream: one int per token per column
+// instead of one object per token.
+//
+// The token class is kept as an index into a table of template tokens shared
+// by every stream, the text as an offset and length into the file source.
+// Consumers that only need the id, line, text or type of a token read the
+// columns directly, the rest can materialize a fresh token object on demand.
+// --
+class TokenColumns {
+  private static Vector<TokenInterface> $_templates = Vector {};
+  private static Map<string, int> $_templateIndex = Map {};
+
+  private Vector<int> $_types;
+  private Vector<int> $_ids;
+  private Vector<int> $_lines;
+  private Vector<int> $_offsets;
+  private Vector<int> $_lengths;
+
+  public function __construct() {
+    $this->_types = Vector {};
+    $this->_ids = Vector {};
+    $this->_lines = Vector {};
+    $this->_offsets = Vector {};
+    $this->_lengths = Vector {};
+  }
+
+  public function add(TokenInterface $token, int $sourceOffset): void {
+    $this->_types->add(self::getTemplateIndex($token));
+    $this->_ids->add($token->getId());
+    $this->_lines->add($token->getLine());
+    $this->_offsets->add($sourceOffset);
+    $this->_lengths->add(strlen(strval($token->getText())));
+  }
+
+  public function count(): int {
+    return $this->_types->count();
+  }
+
+  public function getId(int $position): int {
+    $id = $this->_ids->get($position);
+    if ($id === null) {
+      return -1;
+    }
+    return $id;
+  }
+
+  public function getLine(int $position): int {
+    $line = $this->_lines->get($position);
+    if ($line === null) {
+      return -1;
+    }
+    return $line;
+  }
+
+  public function getText(string $source, int $position): string {
+    $offset = $this->_offsets->get($position);
+    $length = $this->_lengths->get($position);
+    if ($offset === null || $length === null || $length == 0) {
+      return '';
+    }
+    return substr($source, $offset, $length);
+  }
+
+  public function getTokenType(int $position): string {
+    $template = $this->getTemplate($position);
+    if ($template instanceof TokenInterface) {
+      return $template->getTokenType();
+    }
+    return '';
+  }
+
+  public function getShortTokenName(int $position): string {
+    $template = $this->getTemplate($position);
+    if ($template instanceof TokenInterface) {
+      return $template->getShortTokenName();
+    }
+    return '';
+  }
+
+  // --
+  // Builds a new token object for the position, identical to the one the
+  // scanner produced before any parsing touched it.
+  // --
+  public function materialize(
+    File $file,
+    string $source,
+    int $position,
+  ): ?TokenInterface {
+
+    $template = $this->getTemplate($position);
+
+    if (!$template instanceof TokenInterface) {
+      return null;
+    }
+
+    $token = clone $template;
+
+    $token->setAllAttributes(
+      $this->getText($source, $position),
+      $this->getLine($position),
+      $file,
+      $this->getId($position),
+    );
+
+    return $token;
+
+  }
+
+  private function getTemplate(int $position): ?TokenInterface {
+    $type = $this->_types->get($position);
+    if ($type === null) {
+      return null;
+    }
+    return self::$_templates->get($type);
+  }
+
+  private static function getTemplateIndex(TokenInterface $token): int {
+
+    $className = get_class($token);
+
+    $index = self::$_templateIndex->get($className);
+
+    if ($index !== null) {
+      return $index;
+    }
+
+    // a pristine token from the factory, so the template holds on to no file.
+    $shortClassName = substr(strrchr('\\'.$className, '\\'), 1);
+
+    $template = TokenFactory::createTokenFromName($shortClassName);
+
+    if (!$template instanceof TokenInterface) {
+      $template = clone $token;
+    }
+
+    $index = self::$_templates->count();
+
+    self::$_templates->add($template);
+    self::$_templateIndex->set($className, $index);
+
+    return $index;
+
+  }
+
+}
@@ -5,7 +5,6 @@ namespace SebastianBergmann\TokenStream;
 use SebastianBergmann\TokenStream\Token;
 use SebastianBergmann\TokenStream\TokenInterface;
 use SebastianBergmann\TokenStream\Token\Types;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Semicolon;
 
 abstract class TokenEndsWithSemicolon extends Token {
   private int $endOfDefinitionId = -1;
@@ -23,23 +22,8 @@ abstract class TokenEndsWithSemicolon extends Token {
 
     $this->didEndofDefinitionId = true;
 
-    $tokens = $this->tokenStream()->tokens();
-
-    $tokenCount = $tokens->count();
-
-    for ( $i = $this->getId(); $i < $tokenCount; $i++ ) {
-      $token = $tokens->get($i);
-
-      if ( ! $token instanceof TokenInterface ) {
-        break;
-      }
-
-      if ( $token instanceof PHP_Token_Semicolon ) {
-        $this->endOfDefinitionId = $token->getId();
-        break;
-      }
-
-    }
+    $this->endOfDefinitionId =
+      $this->tokenStream()->blockIndex()->getNextSemicolonId($this->getId());
 
     return $this->endOfDefinitionId;
 
@@ -5,17 +5,13 @@ namespace SebastianBergmann\TokenStream;
 use SebastianBergmann\TokenStream\Token;
 use SebastianBergmann\TokenStream\TokenInterface;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Class;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Close_Curly;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Curly_Open;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Comment;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Doc_Comment;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Function;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Namespace;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Open_Curly;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Public;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Private;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Static;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Semicolon;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Trait;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Whitespace;
 use Zynga\CodeBase\V1\File;
@@ -97,42 +93,21 @@ abstract class TokenWithScope extends Token {
       return $this->endTokenId;
     }
 
-    $block = 0;
-    $tokens = $this->tokenStream()->tokens();
-
-    for ($i = $this->getId(); $i < $tokens->count(); $i++) {
-
-      $token = $tokens->get($i);
-
-      if ($token === null) {
-        break;
-      }
-
-      if ($token instanceof PHP_Token_Open_Curly ||
-          $token instanceof PHP_Token_Curly_Open) {
-
-        $block++;
-
-      } else if ($token instanceof PHP_Token_Close_Curly) {
-
-        $block--;
+    $blockIndex = $this->tokenStream()->blockIndex();
 
-        if ($block === 0) {
-          $this->endTokenId = $token->getId();
-          break;
-        }
+    $this->endTokenId = $blockIndex->getEndOfBlockId($this->getId());
 
-      } else if (($this instanceof PHP_Token_Function ||
-                  $this instanceof PHP_Token_Namespace) &&
-                 $token instanceof PHP_Token_Semicolon) {
+    if ($this instanceof PHP_Token_Function ||
+        $this instanceof PHP_Token_Namespace) {
 
-        // This is to support singular line function or namespace suppport, we should consider
-        // swapping them to default to semicolon parser.
-        if ($block === 0) {
-          $this->endTokenId = $token->getId();
-          break;
-        }
+      // This is to support singular line function or namespace suppport, we should consider
+      // swapping them to default to semicolon parser.
+      $endOfStatementId = $blockIndex->getEndOfStatementId($this->getId());
 
+      if ($endOfStatementId !== -1 &&
+          ($this->endTokenId === -1 ||
+           $endOfStatementId < $this->endTokenId)) {
+        $this->endTokenId = $endOfStatementId;
       }
 
     }
@@ -4,7 +4,6 @@ namespace SebastianBergmann\TokenStream;
 
 use SebastianBergmann\TokenStream\TokenWithScope;
 use SebastianBergmann\TokenStream\TokenInterface;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Open_Curly;
 
 abstract class TokenWithScopeStartsWithCurly extends TokenWithScope {
 
@@ -19,18 +18,8 @@ abstract class TokenWithScopeStartsWithCurly extends TokenWithScope {
 
     $this->didEndOfDefinitionId = true;
 
-    $tokens = $this->tokenStream()->tokens();
-
-    for ($i = $this->getId(); $i < $tokens->count(); $i++) {
-
-      $token = $tokens->get($i);
-
-      if ($token instanceof PHP_Token_Open_Curly) {
-        $this->endOfDefinitionId = $token->getId();
-        break;
-      }
-
-    }
+    $this->endOfDefinitionId =
+      $this->tokenStream()->blockIndex()->getNextOpenCurlyId($this->getId());
 
     return $this->endOfDefinitionId;
 
@@ -6,7 +6,6 @@ use SebastianBergmann\TokenStream\TokenWithScope;
 use SebastianBergmann\TokenStream\Token\Types;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Catch;
 use SebastianBergmann\TokenStream\Tokens\PHP_Token_Finally;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Whitespace;
 
 abstract class TryTokens extends TokenWithScope {
   private int $_continuationId = -1;
@@ -22,27 +21,19 @@ abstract class TryTokens extends TokenWithScope {
       return $this->_continuationId;
     }
 
-    $tokens = $this->tokenStream()->tokens();
-
     $this->_didContinuationId = true;
 
-    for ($i = $this->getEndTokenId(); $i < $tokens->count(); $i++) {
+    // The continuation is the first non whitespace token after our block.
+    $stream = $this->tokenStream();
 
-      $token = $tokens->get($i);
+    $nextId =
+      $stream->blockIndex()->getNextNonWhitespaceId($this->getEndTokenId());
 
-      if ($token instanceof PHP_Token_Whitespace) {
-        continue;
-      } else if ($token instanceof PHP_Token_Catch) {
-        $this->_continuationId = $token->getId();
-        break;
-      } else if ($token instanceof PHP_Token_Finally) {
-        $this->_continuationId = $token->getId();
-        break;
-      } else {
-        // anything else is a exit moment.
-        break;
-      }
+    $token = $stream->get($nextId - 1);
 
+    if ($token instanceof PHP_Token_Catch ||
+        $token instanceof PHP_Token_Finally) {
+      $this->_continuationId = $token->getId();
     }
 
     return $this->_continuationId;
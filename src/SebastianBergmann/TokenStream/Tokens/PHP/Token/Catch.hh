@@ -4,7 +4,6 @@ namespace SebastianBergmann\TokenStream\Tokens;
 
 use SebastianBergmann\TokenStream\Tokens\Family\TryTokens;
 use SebastianBergmann\TokenStream\Token\Types;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Open_Curly;
 
 class PHP_Token_Catch extends TryTokens {
   private int $endOfDefinitionId = -1;
@@ -19,14 +18,8 @@ class PHP_Token_Catch extends TryTokens {
       return $this->endOfDefinitionId;
     }
     $this->didEndOfDefinitionId = true;
-    $tokens = $this->tokenStream()->tokens();
-    for ($i = $this->getId(); $i < $tokens->count(); $i++) {
-      $token = $tokens->get($i);
-      if ($token instanceof PHP_Token_Open_Curly) {
-        $this->endOfDefinitionId = $token->getId();
-        break;
-      }
-    }
+    $this->endOfDefinitionId =
+      $this->tokenStream()->blockIndex()->getNextOpenCurlyId($this->getId());
     return $this->endOfDefinitionId;
   }
 
@@ -4,7 +4,6 @@ namespace SebastianBergmann\TokenStream\Tokens;
 
 use SebastianBergmann\TokenStream\Tokens\Family\IfTokens;
 use SebastianBergmann\TokenStream\Token\Types;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Open_Curly;
 
 class PHP_Token_Elseif extends IfTokens {
   private int $endOfDefinitionId = -1;
@@ -26,18 +25,8 @@ class PHP_Token_Elseif extends IfTokens {
 
     $this->didEndOfDefinitionId = true;
 
-    $tokens = $this->tokenStream()->tokens();
-
-    for ($i = $this->getId(); $i < $tokens->count(); $i++) {
-
-      $token = $tokens->get($i);
-
-      if ($token instanceof PHP_Token_Open_Curly) {
-        $this->endOfDefinitionId = $token->getId();
-        break;
-      }
-
-    }
+    $this->endOfDefinitionId =
+      $this->tokenStream()->blockIndex()->getNextOpenCurlyId($this->getId());
 
     return $this->endOfDefinitionId;
 
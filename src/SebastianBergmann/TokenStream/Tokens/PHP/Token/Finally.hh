@@ -4,7 +4,6 @@ namespace SebastianBergmann\TokenStream\Tokens;
 
 use SebastianBergmann\TokenStream\Tokens\Family\TryTokens;
 use SebastianBergmann\TokenStream\Token\Types;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Open_Curly;
 
 // Tokens introduced in PHP 5.5
 class PHP_Token_Finally extends TryTokens {
@@ -24,14 +23,8 @@ class PHP_Token_Finally extends TryTokens {
       return $this->endOfDefinitionId;
     }
     $this->didEndOfDefinitionId = true;
-    $tokens = $this->tokenStream()->tokens();
-    for ($i = $this->getId(); $i < $tokens->count(); $i++) {
-      $token = $tokens->get($i);
-      if ($token instanceof PHP_Token_Open_Curly) {
-        $this->endOfDefinitionId = $token->getId();
-        break;
-      }
-    }
+    $this->endOfDefinitionId =
+      $this->tokenStream()->blockIndex()->getNextOpenCurlyId($this->getId());
     return $this->endOfDefinitionId;
   }
 
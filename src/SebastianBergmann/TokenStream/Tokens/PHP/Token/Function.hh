@@ -45,32 +45,20 @@ class PHP_Token_Function extends TokenWithScopeAndVisibility {
 
     $this->didEndOfDefinitionTokenId = true;
 
-    $tokens = $this->tokenStream()->tokens();
-
-    // echo "skipAmount name=".$this->getName()."\n";
-
-    for ($i = $this->getId(); $i < $tokens->count(); $i++) {
-
-      $token = $tokens->get($i);
-
-      if ($token instanceof PHP_Token_Open_Curly) {
-        $this->endOfDefinitionTokenId = $token->getId();
-        break;
-      }
+    $this->endOfDefinitionTokenId =
+      $this->tokenStream()->blockIndex()->getNextOpenCurlyId($this->getId());
 
-      // --
-      //
-      // @TODO: Write a unit test around multi line abstract function definitions.
-      //
-      // JEO: I think this is the right thing for abstract multi line functions.
-      // Needs a test case to prove.
-      // --
-      // if ($token instanceof PHP_Token_Semicolon) {
-      //   $this->endOfDefinitionId = $token->getId();
-      //   break;
-      // }
-
-    }
+    // --
+    //
+    // @TODO: Write a unit test around multi line abstract function definitions.
+    //
+    // JEO: I think this is the right thing for abstract multi line functions.
+    // Needs a test case to prove.
+    // --
+    // if ($token instanceof PHP_Token_Semicolon) {
+    //   $this->endOfDefinitionId = $token->getId();
+    //   break;
+    // }
 
     return $this->endOfDefinitionTokenId;
 
@@ -4,8 +4,6 @@ namespace SebastianBergmann\TokenStream\Tokens;
 
 use SebastianBergmann\TokenStream\Tokens\Family\IfTokens;
 use SebastianBergmann\TokenStream\Token\Types;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Open_Curly;
-use SebastianBergmann\TokenStream\Tokens\PHP_Token_Semicolon;
 
 class PHP_Token_If extends IfTokens {
   private int $endOfDefinitionId = -1;
@@ -20,17 +18,15 @@ class PHP_Token_If extends IfTokens {
       return $this->endOfDefinitionId;
     }
     $this->didEndOfDefinitionId = true;
-    $tokens = $this->tokenStream()->tokens();
-    for ($i = $this->getId(); $i < $tokens->count(); $i++) {
-      $token = $tokens->get($i);
-      if ($token instanceof PHP_Token_Open_Curly) {
-        $this->endOfDefinitionId = $token->getId();
-        break;
-      }
-      if ($token instanceof PHP_Token_Semicolon) {
-        $this->endOfDefinitionId = $token->getId();
-        break;
-      }
+    $blockIndex = $this->tokenStream()->blockIndex();
+    $openCurlyId = $blockIndex->getNextOpenCurlyId($this->getId());
+    $semicolonId = $blockIndex->getNextSemicolonId($this->getId());
+    // whichever of the two comes first ends the definition.
+    if ($openCurlyId === -1 ||
+        ($semicolonId !== -1 && $semicolonId < $openCurlyId)) {
+      $this->endOfDefinitionId = $semicolonId;
+    } else {
+      $this->endOfDefinitionId = $openCurlyId;
     }
     return $this->endOfDefinitionId;
   }
@@ -0,0 +1,442 @@
+<?hh // strict
+
+namespace Zynga\CodeBase\V1;
+
+use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\FileCache;
+use Zynga\CodeBase\V1\FileFactory;
+
+use \ReflectionClass;
+
+// --
+// Line to test attribution from a previous coverage run, along with the
+// content hashes of the files it was recorded against.
+//
+// An incremental run compares the whitelist against the recorded hashes and
+// only re-runs the test classes that touched a changed file, plus any test
+// class that is new or whose own source changed. Once those have run, the
+// recorded attribution for everything that was not re-run is merged back
+// into the files, so reports and the next baseline cover the whole suite.
+// --
+class CoverageBaseline {
+  const string FORMAT_VERSION = '1';
+
+  private string $_baselineFile;
+  private bool $_isLoaded;
+
+  // file => content hash
+  private Map<string, string> $_fileHashes;
+
+  // file => line => test ids
+  private Map<string, Map<int, Vector<string>>> $_lineToTests;
+
+  // test class => (test file, content hash of the test file)
+  private Map<string, (string, string)> $_testClasses;
+
+  private Vector<string> $_changedFiles;
+  private Map<string, bool> $_selectedClasses;
+  private Map<string, bool> $_classSelection;
+
+  public function __construct(string $baselineFile) {
+    $this->_baselineFile = $baselineFile;
+    $this->_isLoaded = false;
+
+    $this->_fileHashes = Map {};
+    $this->_lineToTests = Map {};
+    $this->_testClasses = Map {};
+
+    $this->_changedFiles = Vector {};
+    $this->_selectedClasses = Map {};
+    $this->_classSelection = Map {};
+  }
+
+  public function getBaselineFile(): string {
+    return $this->_baselineFile;
+  }
+
+  public function isLoaded(): bool {
+    return $this->_isLoaded;
+  }
+
+  public function load(): bool {
+
+    if (!is_file($this->_baselineFile)) {
+      return false;
+    }
+
+    $payload = file_get_contents($this->_baselineFile);
+
+    if (!is_string($payload) || $payload == '') {
+      return false;
+    }
+
+    $data = unserialize($payload);
+
+    if (!is_array($data) ||
+        !array_key_exists('version', $data) ||
+        $data['version'] !== self::FORMAT_VERSION) {
+      return false;
+    }
+
+    $files = array_key_exists('files', $data) ? $data['files'] : null;
+    $testClasses =
+      array_key_exists('testClasses', $data) ? $data['testClasses'] : null;
+
+    if (!is_array($files) || !is_array($testClasses)) {
+      return false;
+    }
+
+    foreach ($files as $fileName => $fileData) {
+
+      if (!is_array($fileData) || count($fileData) != 2) {
+        return false;
+      }
+
+      list($hash, $lines) = $fileData;
+
+      $lineToTests = Map {};
+
+      if (is_array($lines)) {
+        foreach ($lines as $lineNo => $testIds) {
+          if (is_array($testIds)) {
+            $lineToTests->set(intval($lineNo), new Vector($testIds));
+          }
+        }
+      }
+
+      $this->_fileHashes->set(strval($fileName), strval($hash));
+      $this->_lineToTests->set(strval($fileName), $lineToTests);
+
+    }
+
+    foreach ($testClasses as $className => $classData) {
+      if (is_array($classData) && count($classData) == 2) {
+        $this->_testClasses->set(
+          strval($className),
+          tuple(strval($classData[0]), strval($classData[1])),
+        );
+      }
+    }
+
+    $this->_isLoaded = true;
+
+    return true;
+
+  }
+
+  // --
+  // Works out which whitelisted files changed since the baseline and which
+  // test classes have to run again because of it.
+  // --
+  public function computeSelection(Vector<string> $whitelist): void {
+
+    $this->_changedFiles->clear();
+    $this->_selectedClasses->clear();
+    $this->_classSelection->clear();
+
+    $seen = Map {};
+
+    foreach ($whitelist as $fileName) {
+
+      $seen->set($fileName, true);
+
+      $recordedHash = $this->_fileHashes->get($fileName);
+
+      if ($recordedHash === null ||
+          $recordedHash !== $this->hashFile($fileName)) {
+        $this->_changedFiles->add($fileName);
+      }
+
+    }
+
+    // files that went away take their attribution with them.
+    foreach ($this->_fileHashes->keys() as $fileName) {
+      if ($seen->containsKey($fileName) !== true) {
+        $this->_changedFiles->add($fileName);
+      }
+    }
+
+    foreach ($this->_changedFiles as $fileName) {
+
+      $lineToTests = $this->_lineToTests->get($fileName);
+
+      if ($lineToTests === null) {
+        continue;
+      }
+
+      foreach ($lineToTests as $testIds) {
+        foreach ($testIds as $testId) {
+          $this->_selectedClasses->set($this->getTestClass($testId), true);
+        }
+      }
+
+    }
+
+  }
+
+  public function getChangedFiles(): Vector<string> {
+    return $this->_changedFiles;
+  }
+
+  public function isTestClassSelected(string $className): bool {
+
+    $isSelected = $this->_classSelection->get($className);
+
+    if ($isSelected !== null) {
+      return $isSelected;
+    }
+
+    $isSelected = false;
+
+    $recorded = $this->_testClasses->get($className);
+
+    if ($this->_selectedClasses->containsKey($className) === true) {
+      $isSelected = true;
+    } else if ($recorded === null) {
+      // never seen it, so nothing is known about what it covers.
+      $isSelected = true;
+    } else {
+      list($testFile, $hash) = $recorded;
+      if ($hash !== $this->hashFile($testFile)) {
+        $isSelected = true;
+      }
+    }
+
+    $this->_classSelection->set($className, $isSelected);
+
+    return $isSelected;
+
+  }
+
+  // --
+  // Restores the recorded attribution of every test class that was not run
+  // again onto the files that did not change.
+  // --
+  public function mergeInto(): void {
+
+    $changed = Map {};
+    foreach ($this->_changedFiles as $fileName) {
+      $changed->set($fileName, true);
+    }
+
+    foreach ($this->_lineToTests as $fileName => $lineToTests) {
+
+      if ($changed->containsKey($fileName) === true || !is_file($fileName)) {
+        continue;
+      }
+
+      $file = FileFactory::get($fileName);
+
+      $executedLines = Vector {};
+
+      foreach ($lineToTests as $lineNo => $testIds) {
+        $isExecuted = false;
+        foreach ($testIds as $testId) {
+          if ($this->isTestClassSelected($this->getTestClass($testId)) ===
+              true) {
+            continue;
+          }
+          $file->setLineToTest($lineNo, $testId);
+          $isExecuted = true;
+        }
+        if ($isExecuted === true) {
+          $executedLines->add($lineNo);
+        }
+      }
+
+      $file->lineExecutionState()->markExecutedLines($executedLines);
+
+    }
+
+  }
+
+  // --
+  // Writes the attribution currently held by the registered files as the new
+  // baseline.
+  // --
+  public function save(): bool {
+
+    $files = array();
+    $testClasses = array();
+
+    foreach (FileFactory::getFileNames() as $fileName) {
+
+      $file = FileFactory::get($fileName);
+
+      $lines = $file->lineToTestToArrayFormat();
+
+      foreach ($lines as $lineNo => $testIds) {
+        foreach ($testIds as $testId) {
+          $className = $this->getTestClass($testId);
+          if (!array_key_exists($className, $testClasses)) {
+            $testFile = $this->getTestClassFile($className);
+            $testClasses[$className] =
+              array($testFile, $this->hashFile($testFile));
+          }
+        }
+      }
+
+      $files[$fileName] = array(FileCache::getContentHash($file), $lines);
+
+    }
+
+    // classes that were skipped this run without covering anything would
+    // otherwise look brand new next time.
+    foreach ($this->_testClasses as $className => $recorded) {
+      if (!array_key_exists($className, $testClasses) &&
+          $this->isTestClassSelected($className) !== true) {
+        list($testFile, $hash) = $recorded;
+        $testClasses[$className] = array($testFile, $hash);
+      }
+    }
+
+    return $this->write($files, $testClasses);
+
+  }
+
+  // --
+  // Folds another baseline into this one, as recorded by a run over a
+  // different part of the suite against the same sources, such as another
+  // shard. Attribution of a line is the union of both.
+  // --
+  public function merge(CoverageBaseline $other): void {
+
+    foreach ($other->_fileHashes as $fileName => $hash) {
+      if ($this->_fileHashes->containsKey($fileName) !== true) {
+        $this->_fileHashes->set($fileName, $hash);
+      }
+    }
+
+    foreach ($other->_lineToTests as $fileName => $otherLines) {
+
+      $lineToTests = $this->_lineToTests->get($fileName);
+
+      if ($lineToTests === null) {
+        $lineToTests = Map {};
+        $this->_lineToTests->set($fileName, $lineToTests);
+      }
+
+      foreach ($otherLines as $lineNo => $otherTestIds) {
+        $testIds = $lineToTests->get($lineNo);
+        if ($testIds === null) {
+          $lineToTests->set($lineNo, new Vector($otherTestIds));
+          continue;
+        }
+        foreach ($otherTestIds as $testId) {
+          if ($testIds->linearSearch($testId) == -1) {
+            $testIds->add($testId);
+          }
+        }
+      }
+
+    }
+
+    foreach ($other->_testClasses as $className => $recorded) {
+      if ($this->_testClasses->containsKey($className) !== true) {
+        $this->_testClasses->set($className, $recorded);
+      }
+    }
+
+    $this->_isLoaded = true;
+
+  }
+
+  // --
+  // Writes what was loaded and merged, rather than the registered files.
+  // --
+  public function saveMerged(): bool {
+
+    $files = array();
+
+    foreach ($this->_fileHashes as $fileName => $hash) {
+      $lines = array();
+      $lineToTests = $this->_lineToTests->get($fileName);
+      if ($lineToTests !== null) {
+        foreach ($lineToTests as $lineNo => $testIds) {
+          $lines[$lineNo] = $testIds->toArray();
+        }
+      }
+      $files[$fileName] = array($hash, $lines);
+    }
+
+    $testClasses = array();
+
+    foreach ($this->_testClasses as $className => $recorded) {
+      list($testFile, $hash) = $recorded;
+      $testClasses[$className] = array($testFile, $hash);
+    }
+
+    return $this->write($files, $testClasses);
+
+  }
+
+  private function write(
+    array<string, array<mixed>> $files,
+    array<string, array<string>> $testClasses,
+  ): bool {
+
+    $data = array(
+      'version' => self::FORMAT_VERSION,
+      'files' => $files,
+      'testClasses' => $testClasses,
+    );
+
+    $baselineDir = dirname($this->_baselineFile);
+
+    if (!is_dir($baselineDir)) {
+      @mkdir($baselineDir, 0755, true);
+    }
+
+    $tmpFile = $this->_baselineFile.'.'.getmypid().'.tmp';
+
+    if (file_put_contents($tmpFile, serialize($data)) === false) {
+      return false;
+    }
+
+    return rename($tmpFile, $this->_baselineFile);
+
+  }
+
+  private function getTestClass(string $testId): string {
+    $offset = strpos($testId, '::');
+    if ($offset === false) {
+      return $testId;
+    }
+    return substr($testId, 0, $offset);
+  }
+
+  private function getTestClassFile(string $className): string {
+
+    if (!class_exists($className, false)) {
+      return '';
+    }
+
+    $reflection = new ReflectionClass($className);
+
+    $testFile = $reflection->getFileName();
+
+    if (!is_string($testFile)) {
+      return '';
+    }
+
+    return $testFile;
+
+  }
+
+  private function hashFile(string $fileName): string {
+
+    if ($fileName == '' || !is_file($fileName)) {
+      return '';
+    }
+
+    $hash = sha1_file($fileName);
+
+    if (!is_string($hash)) {
+      return '';
+    }
+
+    return $hash;
+
+  }
+
+}
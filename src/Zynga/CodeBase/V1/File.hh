@@ -45,12 +45,15 @@ use SebastianBergmann\TokenStream\Tokens\PHP_Token_Variable;
 
 use SebastianBergmann\TokenStream\TokenInterface;
 
+use Zynga\CodeBase\V1\FileCache;
+use Zynga\CodeBase\V1\TestIds;
+use Zynga\CodeBase\V1\File\Analysis;
 use Zynga\CodeBase\V1\File\Classes;
 use Zynga\CodeBase\V1\File\Functions;
 use Zynga\CodeBase\V1\File\Inclusions;
 use Zynga\CodeBase\V1\File\Interfaces;
 use Zynga\CodeBase\V1\File\LineExecutionState;
-use Zynga\CodeBase\V1\File\RawTokens;
+use Zynga\CodeBase\V1\File\LineToTests;
 use Zynga\CodeBase\V1\File\Source;
 use Zynga\CodeBase\V1\File\Stats;
 use Zynga\CodeBase\V1\File\Traits;
@@ -58,16 +61,18 @@ use Zynga\CodeBase\V1\File\Traits;
 class File {
   private bool $_didInit;
   private string $_file;
-  private Map<int, Map<string, bool>> $_lineToTests;
   private int $_startLine;
   private int $_endLine;
+  private bool $_isHydrated;
+  private ?Map<string, int> $_linesOfCode;
 
+  private ?Analysis $_analysis;
   private ?Classes $_classes;
   private ?Functions $_functions;
   private ?Inclusions $_inclusions;
   private ?Interfaces $_interfaces;
   private ?LineExecutionState $_lineExecutionState;
-  private ?RawTokens $_rawTokens;
+  private ?LineToTests $_lineToTests;
   private ?Source $_source;
   private ?Stats $_stats;
   private ?Stream $_stream;
@@ -76,16 +81,18 @@ class File {
   public function __construct(string $file) {
     $this->_didInit = false;
     $this->_file = $file;
-    $this->_lineToTests = Map {};
     $this->_startLine = -1;
     $this->_endLine = -1;
+    $this->_isHydrated = false;
+    $this->_linesOfCode = null;
 
+    $this->_analysis = null;
     $this->_classes = null;
     $this->_functions = null;
     $this->_inclusions = null;
     $this->_interfaces = null;
     $this->_lineExecutionState = null;
-    $this->_rawTokens = null;
+    $this->_lineToTests = null;
     $this->_source = null;
     $this->_stats = null;
     $this->_stream = null;
@@ -107,16 +114,6 @@ class File {
 
   }
 
-  public function rawTokens(): RawTokens {
-    if ($this->_rawTokens instanceof RawTokens) {
-      return $this->_rawTokens;
-    }
-
-    $this->_rawTokens = new RawTokens($this);
-    return $this->_rawTokens;
-
-  }
-
   public function stats(): Stats {
 
     if ($this->_stats instanceof Stats) {
@@ -128,6 +125,18 @@ class File {
 
   }
 
+  public function analysis(): Analysis {
+
+    if ($this->_analysis instanceof Analysis) {
+      return $this->_analysis;
+    }
+
+    $this->_analysis = new Analysis($this);
+
+    return $this->_analysis;
+
+  }
+
   public function lineExecutionState(): LineExecutionState {
 
     // We can only call this -after- stream has already populated.
@@ -201,39 +210,38 @@ class File {
 
   }
 
-  public function getLinesToTests(): Map<int, Vector<string>> {
-    $data = Map {};
+  public function lineToTests(): LineToTests {
 
-    // unroll the map, into a vector for ease of use.
-    foreach ($this->_lineToTests as $lineNo => $testsMap) {
-      $data->set($lineNo, $testsMap->keys());
+    if ($this->_lineToTests instanceof LineToTests) {
+      return $this->_lineToTests;
     }
 
-    return $data;
-  }
+    $this->_lineToTests = new LineToTests($this);
 
-  public function setLineToTest(int $lineNo, string $testId): void {
+    return $this->_lineToTests;
 
-    $data = $this->_lineToTests->get($lineNo);
+  }
 
-    if (!$data instanceof Map) {
-      $data = Map {};
-    }
+  public function getLinesToTests(): Map<int, Vector<string>> {
+    $data = Map {};
 
-    $data->set($testId, true);
+    foreach ($this->lineToTests()->getLines() as $lineNo) {
+      $data->set($lineNo, $this->lineToTests()->getTestNames($lineNo));
+    }
 
-    $this->_lineToTests->set($lineNo, $data);
+    return $data;
+  }
 
+  public function setLineToTest(int $lineNo, string $testId): void {
+    $this->lineToTests()->add($lineNo, TestIds::intern($testId));
   }
 
   public function lineToTestToArrayFormat(): array<int, array<string>> {
     $data = array();
 
-    foreach ($this->_lineToTests as $lineNo => $testsMap) {
-      $data[$lineNo] = array();
-      foreach ($testsMap as $testId => $tested) {
-        $data[$lineNo][] = $testId;
-      }
+    foreach ($this->lineToTests()->getLines() as $lineNo) {
+      $data[$lineNo] =
+        $this->lineToTests()->getTestNames($lineNo)->toArray();
     }
 
     return $data;
@@ -251,8 +259,12 @@ class File {
     $scanner->scan($this, $stream);
     $this->_stream = $stream;
 
-    $parser = new StreamParser();
-    $parser->parse($this, $stream);
+    // When the structure was hydrated from a prior analysis the parser has
+    // nothing left to contribute, the stream is only wanted for its tokens.
+    if ($this->_isHydrated === false) {
+      $parser = new StreamParser();
+      $parser->parse($this, $stream);
+    }
 
     $this->_stream = $stream;
     return $this->_stream;
@@ -671,8 +683,11 @@ class File {
     // load the source for this file.
     $this->source()->load();
 
-    // get the raw tokens loaded.
-    $this->rawTokens()->load();
+    // unchanged files can skip tokenization entirely.
+    if (FileCache::load($this) === true) {
+      $this->debug(Map {'action' => 'init-from-cache'});
+      return;
+    }
 
     $lineCount = $this->stream()->getLineCount();
     $lineToTokens = $this->stream()->getLineToTokensForLine();
@@ -726,14 +741,70 @@ class File {
     $this->debug(Map {'action' => 'init-complete'});
     $this->_didInit = true;
 
+    FileCache::save($this);
+
+    // the analysis is done with the token objects, keep the columns only.
+    $this->stream()->compact();
+
+  }
+
+  // --
+  // Populates this file from a previously exported analysis instead of
+  // tokenizing it, see File\Analysis.
+  // --
+  public function hydrate(array<string, mixed> $analysis): bool {
+
+    if ($this->analysis()->import($analysis) !== true) {
+      // drop whatever the partial import left behind.
+      $this->_classes = null;
+      $this->_functions = null;
+      $this->_inclusions = null;
+      $this->_interfaces = null;
+      $this->_lineExecutionState = null;
+      $this->_linesOfCode = null;
+      $this->_traits = null;
+      return false;
+    }
+
+    $this->_isHydrated = true;
+    $this->_didInit = true;
+
+    return true;
+
+  }
+
+  public function isHydrated(): bool {
+    return $this->_isHydrated;
   }
 
   public function getStartLine(): int {
     return $this->_startLine;
   }
 
+  public function setStartLine(int $startLine): void {
+    $this->_startLine = $startLine;
+  }
+
   public function getEndLine(): int {
     return $this->_endLine;
   }
 
+  public function setEndLine(int $endLine): void {
+    $this->_endLine = $endLine;
+  }
+
+  public function getLinesOfCode(): Map<string, int> {
+
+    if ($this->_linesOfCode instanceof Map) {
+      return $this->_linesOfCode;
+    }
+
+    return $this->stream()->getLinesOfCode();
+
+  }
+
+  public function setLinesOfCode(Map<string, int> $linesOfCode): void {
+    $this->_linesOfCode = $linesOfCode;
+  }
+
 }
@@ -0,0 +1,331 @@
+<?hh // strict
+
+namespace Zynga\CodeBase\V1\File;
+
+use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\Code\Code_Class;
+use Zynga\CodeBase\V1\Code\Code_Interface;
+use Zynga\CodeBase\V1\Code\Code_Method;
+use Zynga\CodeBase\V1\File\ExecutableRange;
+
+// --
+// The analysis is the result of File::init() flattened down to plain arrays,
+// so it can be persisted or shipped between processes without dragging the
+// token stream along with it.
+// --
+class Analysis {
+  private File $_parent;
+
+  public function __construct(File $parent) {
+    $this->_parent = $parent;
+  }
+
+  public function export(): array<string, mixed> {
+
+    $file = $this->_parent;
+
+    $lineStates = array();
+    foreach ($file->lineExecutionState()->getAll() as $lineNo => $lineState) {
+      $lineStates[$lineNo] = $lineState;
+    }
+
+    $ranges = array();
+    foreach ($file->lineExecutionState()->getExecutableRangeIntervals() as
+             $interval) {
+      list($firstLine, $lastLine, $range) = $interval;
+      $ranges[] = array(
+        $firstLine,
+        $lastLine,
+        $range->getReason(),
+        $range->getStart(),
+        $range->getEnd(),
+      );
+    }
+
+    $classes = array();
+    foreach ($file->classes()->getAll() as $name => $classObj) {
+      $classes[$name] = $this->exportClass($classObj);
+    }
+
+    $traits = array();
+    foreach ($file->traits()->getAll() as $name => $traitObj) {
+      $traits[$name] = $this->exportClass($traitObj);
+    }
+
+    $interfaces = array();
+    foreach ($file->interfaces()->getAll() as $name => $interfaceObj) {
+      $interfaces[$name] = $this->exportInterface($interfaceObj);
+    }
+
+    $functions = array();
+    foreach ($file->functions()->getAll() as $name => $functionObj) {
+      $functions[$name] = $this->exportMethod($functionObj);
+    }
+
+    $inclusions = array();
+    foreach ($file->inclusions()->getAllAsMap() as $type => $includedFiles) {
+      $inclusions[$type] = $includedFiles->toArray();
+    }
+
+    return array(
+      'startLine' => $file->getStartLine(),
+      'endLine' => $file->getEndLine(),
+      'lineStates' => $lineStates,
+      'ranges' => $ranges,
+      'classes' => $classes,
+      'traits' => $traits,
+      'interfaces' => $interfaces,
+      'functions' => $functions,
+      'inclusions' => $inclusions,
+      'linesOfCode' => $file->getLinesOfCode()->toArray(),
+    );
+
+  }
+
+  public function import(array<string, mixed> $data): bool {
+
+    $file = $this->_parent;
+
+    $file->setStartLine($this->getInt($data, 'startLine'));
+    $file->setEndLine($this->getInt($data, 'endLine'));
+
+    foreach ($this->getArray($data, 'lineStates') as $lineNo => $lineState) {
+      $file->lineExecutionState()->set(intval($lineNo), intval($lineState));
+    }
+
+    foreach ($this->getArray($data, 'ranges') as $range) {
+      if (!is_array($range) || count($range) != 5) {
+        return false;
+      }
+      $file->lineExecutionState()->addRangeToLines(
+        intval($range[0]),
+        intval($range[1]),
+        new ExecutableRange(
+          strval($range[2]),
+          intval($range[3]),
+          intval($range[4]),
+        ),
+      );
+    }
+
+    foreach ($this->getArray($data, 'classes') as $name => $classData) {
+      if (is_array($classData)) {
+        $file->classes()->add(strval($name), $this->importClass($classData));
+      }
+    }
+
+    foreach ($this->getArray($data, 'traits') as $name => $traitData) {
+      if (is_array($traitData)) {
+        $file->traits()->add(strval($name), $this->importClass($traitData));
+      }
+    }
+
+    foreach ($this->getArray($data, 'interfaces') as $name => $interfaceData) {
+      if (is_array($interfaceData)) {
+        $file->interfaces()
+          ->add(strval($name), $this->importInterface($interfaceData));
+      }
+    }
+
+    foreach ($this->getArray($data, 'functions') as $name => $functionData) {
+      if (is_array($functionData)) {
+        $file->functions()
+          ->add(strval($name), $this->importMethod($functionData));
+      }
+    }
+
+    foreach ($this->getArray($data, 'inclusions') as $type => $includedFiles) {
+      if (!is_array($includedFiles)) {
+        continue;
+      }
+      $inclusion = null;
+      if ($type == 'require') {
+        $inclusion = $file->inclusions()->requires();
+      } else if ($type == 'require_once') {
+        $inclusion = $file->inclusions()->require_onces();
+      } else if ($type == 'include') {
+        $inclusion = $file->inclusions()->includes();
+      } else if ($type == 'include_once') {
+        $inclusion = $file->inclusions()->include_onces();
+      }
+      if ($inclusion === null) {
+        continue;
+      }
+      foreach ($includedFiles as $includedFile) {
+        $inclusion->add(strval($includedFile));
+      }
+    }
+
+    $linesOfCode = Map {};
+    foreach ($this->getArray($data, 'linesOfCode') as $key => $value) {
+      $linesOfCode->set(strval($key), intval($value));
+    }
+    $file->setLinesOfCode($linesOfCode);
+
+    return true;
+
+  }
+
+  private function exportClass(Code_Class $classObj): array<string, mixed> {
+
+    $methods = array();
+    foreach ($classObj->methods as $name => $methodObj) {
+      $methods[$name] = $this->exportMethod($methodObj);
+    }
+
+    return array(
+      'className' => $classObj->className,
+      'parent' => $classObj->parent,
+      'interfaces' => $classObj->interfaces,
+      'package' => $classObj->package->toArray(),
+      'keywords' => $classObj->keywords,
+      'docblock' => $classObj->docblock,
+      'startLine' => $classObj->startLine,
+      'endLine' => $classObj->endLine,
+      'link' => $classObj->link,
+      'ccn' => $classObj->getCcn(),
+      'methods' => $methods,
+    );
+
+  }
+
+  private function importClass(array<string, mixed> $data): Code_Class {
+
+    $classObj = new Code_Class();
+    $classObj->file = $this->_parent->getFile();
+    $classObj->className = $this->getString($data, 'className');
+    $classObj->parent = $this->getMixed($data, 'parent');
+    $classObj->interfaces = $this->getMixed($data, 'interfaces');
+    $classObj->keywords = $this->getString($data, 'keywords');
+    $classObj->docblock = $this->getString($data, 'docblock');
+    $classObj->startLine = $this->getInt($data, 'startLine');
+    $classObj->endLine = $this->getInt($data, 'endLine');
+    $classObj->link = $this->getString($data, 'link');
+    $classObj->setCcn($this->getInt($data, 'ccn'));
+
+    foreach ($this->getArray($data, 'package') as $key => $value) {
+      $classObj->package->set(strval($key), strval($value));
+    }
+
+    foreach ($this->getArray($data, 'methods') as $name => $methodData) {
+      if (is_array($methodData)) {
+        $classObj->methods->set(strval($name), $this->importMethod($methodData));
+      }
+    }
+
+    return $classObj;
+
+  }
+
+  private function exportInterface(
+    Code_Interface $interfaceObj,
+  ): array<string, mixed> {
+
+    $methods = array();
+    foreach ($interfaceObj->methods as $name => $methodObj) {
+      $methods[$name] = $this->exportMethod($methodObj);
+    }
+
+    return array(
+      'parent' => $interfaceObj->parent,
+      'interfaces' => $interfaceObj->interfaces,
+      'package' => $interfaceObj->package->toArray(),
+      'keywords' => $interfaceObj->keywords,
+      'docblock' => $interfaceObj->docblock,
+      'startLine' => $interfaceObj->startLine,
+      'endLine' => $interfaceObj->endLine,
+      'methods' => $methods,
+    );
+
+  }
+
+  private function importInterface(array<string, mixed> $data): Code_Interface {
+
+    $interfaceObj = new Code_Interface();
+    $interfaceObj->file = $this->_parent->getFile();
+    $interfaceObj->parent = $this->getMixed($data, 'parent');
+    $interfaceObj->interfaces = $this->getMixed($data, 'interfaces');
+    $interfaceObj->keywords = $this->getString($data, 'keywords');
+    $interfaceObj->docblock = $this->getString($data, 'docblock');
+    $interfaceObj->startLine = $this->getInt($data, 'startLine');
+    $interfaceObj->endLine = $this->getInt($data, 'endLine');
+
+    foreach ($this->getArray($data, 'package') as $key => $value) {
+      $interfaceObj->package->set(strval($key), strval($value));
+    }
+
+    foreach ($this->getArray($data, 'methods') as $name => $methodData) {
+      if (is_array($methodData)) {
+        $interfaceObj->methods
+          ->set(strval($name), $this->importMethod($methodData));
+      }
+    }
+
+    return $interfaceObj;
+
+  }
+
+  private function exportMethod(Code_Method $methodObj): array<string, mixed> {
+    return array(
+      'methodName' => $methodObj->methodName,
+      'visibility' => $methodObj->visibility,
+      'signature' => $methodObj->signature,
+      'keywords' => $methodObj->keywords,
+      'docblock' => $methodObj->docblock,
+      'startLine' => $methodObj->startLine,
+      'endLine' => $methodObj->endLine,
+      'link' => $methodObj->link,
+      'ccn' => $methodObj->getCcn(),
+    );
+  }
+
+  private function importMethod(array<string, mixed> $data): Code_Method {
+
+    $methodObj = new Code_Method();
+    $methodObj->file = $this->_parent->getFile();
+    $methodObj->methodName = $this->getString($data, 'methodName');
+    $methodObj->visibility = $this->getString($data, 'visibility');
+    $methodObj->signature = $this->getString($data, 'signature');
+    $methodObj->keywords = $this->getString($data, 'keywords');
+    $methodObj->docblock = $this->getString($data, 'docblock');
+    $methodObj->startLine = $this->getInt($data, 'startLine');
+    $methodObj->endLine = $this->getInt($data, 'endLine');
+    $methodObj->link = $this->getString($data, 'link');
+    $methodObj->setCcn($this->getInt($data, 'ccn'));
+
+    return $methodObj;
+
+  }
+
+  private function getMixed(array<string, mixed> $data, string $key): mixed {
+    if (array_key_exists($key, $data)) {
+      return $data[$key];
+    }
+    return false;
+  }
+
+  private function getArray(array<string, mixed> $data, string $key): array {
+    $value = $this->getMixed($data, $key);
+    if (is_array($value)) {
+      return $value;
+    }
+    return array();
+  }
+
+  private function getInt(array<string, mixed> $data, string $key): int {
+    $value = $this->getMixed($data, $key);
+    if (is_int($value)) {
+      return $value;
+    }
+    return -1;
+  }
+
+  private function getString(array<string, mixed> $data, string $key): string {
+    $value = $this->getMixed($data, $key);
+    if (is_string($value)) {
+      return $value;
+    }
+    return '';
+  }
+
+}
@@ -6,30 +6,103 @@ use SebastianBergmann\CodeCoverage\Driver;
 use Zynga\CodeBase\V1\File;
 use Zynga\CodeBase\V1\File\ExecutableRange;
 
+// --
+// Line states are packed one byte per line into a string indexed by line
+// number, a zero byte meaning no state was recorded for that line. Negative
+// line numbers have no slot and are ignored.
+//
+// Executable ranges are kept once each as an interval of the lines they apply
+// to, rather than registered against every line they span. Lookups sort the
+// intervals by their first line and binary search them, the running max of
+// the last lines lets the search stop as soon as no earlier interval can
+// reach the line asked for.
+// --
 class LineExecutionState {
+  // Driver line states run from -2 to 1, shifted so none of them packs to 0.
+  const int STATE_OFFSET = 3;
+
   private File $_parent;
-  private Map<int, int> $_lineExecutionState;
-  private Map<int, Vector<ExecutableRange>> $_executableRanges;
+  private string $_lineExecutionState;
+
+  private Vector<ExecutableRange> $_ranges;
+  private Vector<int> $_rangeFirstLines;
+  private Vector<int> $_rangeLastLines;
+  private Vector<int> $_sortedRanges;
+  private Vector<int> $_sortedMaxLastLines;
+  private bool $_isSorted;
+  private Map<int, bool> $_appliedRanges;
 
   public function __construct(File $parent) {
     $this->_parent = $parent;
-    $this->_lineExecutionState = Map {};
-    $this->_executableRanges = Map {};
+    $this->_lineExecutionState = '';
+
+    $this->_ranges = Vector {};
+    $this->_rangeFirstLines = Vector {};
+    $this->_rangeLastLines = Vector {};
+    $this->_sortedRanges = Vector {};
+    $this->_sortedMaxLastLines = Vector {};
+    $this->_isSorted = true;
+    $this->_appliedRanges = Map {};
   }
 
   public function isLineWithinExecutableRange(int $lineNo): bool {
-    if ($this->_executableRanges->containsKey($lineNo) === true) {
+    if ($this->findRangeOffsets($lineNo, true)->count() > 0) {
       return true;
     }
     return false;
   }
 
   public function getExecutableRanges(int $lineNo): Vector<ExecutableRange> {
-    $ranges = $this->_executableRanges->get($lineNo);
-    if ( $ranges instanceof Vector ) {
-      return $ranges;
+    $ranges = Vector {};
+    foreach ($this->findRangeOffsets($lineNo, false) as $offset) {
+      $ranges->add($this->_ranges[$offset]);
     }
-    return Vector {};
+    return $ranges;
+  }
+
+  // --
+  // Expands the intervals back out into a per line map, only meant for
+  // debugging as it costs what the packed storage saves.
+  // --
+  public function getAllExecutableRanges(): Map<int, Vector<ExecutableRange>> {
+
+    $data = Map {};
+
+    foreach ($this->_ranges as $offset => $range) {
+      $lastLine = $this->_rangeLastLines[$offset];
+      for ($lineNo = $this->_rangeFirstLines[$offset];
+           $lineNo <= $lastLine;
+           $lineNo++) {
+        $lineRanges = $data->get($lineNo);
+        if (!$lineRanges instanceof Vector) {
+          $lineRanges = Vector {};
+          $data->set($lineNo, $lineRanges);
+        }
+        $lineRanges->add($range);
+      }
+    }
+
+    return $data;
+
+  }
+
+  // --
+  // Every range along with the first and last line it applies to, in the
+  // order they were added.
+  // --
+  public function getExecutableRangeIntervals(
+  ): Vector<(int, int, ExecutableRange)> {
+    $intervals = Vector {};
+    foreach ($this->_ranges as $offset => $range) {
+      $intervals->add(
+        tuple(
+          $this->_rangeFirstLines[$offset],
+          $this->_rangeLastLines[$offset],
+          $range,
+        ),
+      );
+    }
+    return $intervals;
   }
 
   public function addFiniteExecutableRange(
@@ -43,19 +116,7 @@ class LineExecutionState {
   }
 
   public function addRangeToLineNo(int $lineNo, ExecutableRange $range): bool {
-
-    $currentRanges = $this->_executableRanges->get($lineNo);
-
-    if ( ! $currentRanges instanceof Vector ) {
-      $currentRanges = Vector {};
-    }
-
-    $currentRanges->add($range);
-
-    $this->_executableRanges->set($lineNo, $currentRanges);
-
-    return true;
-
+    return $this->addRangeToLines($lineNo, $lineNo, $range);
   }
 
   public function addExecutableRange(
@@ -64,19 +125,46 @@ class LineExecutionState {
     int $endLine,
   ): bool {
 
+    if ($endLine < $startLine) {
+      // nothing to span, same as the old line by line registration.
+      return true;
+    }
 
     $executableRange = new ExecutableRange($reason, $startLine, $endLine);
 
-    for ($lineNo = $startLine; $lineNo <= $endLine; $lineNo++) {
-      $this->addRangeToLineNo($lineNo, $executableRange);
-    }
+    return $this->addRangeToLines($startLine, $endLine, $executableRange);
+
+  }
+
+  public function addRangeToLines(
+    int $firstLine,
+    int $lastLine,
+    ExecutableRange $range,
+  ): bool {
+
+    $this->_ranges->add($range);
+    $this->_rangeFirstLines->add($firstLine);
+    $this->_rangeLastLines->add($lastLine);
+    $this->_isSorted = false;
 
     return true;
 
   }
 
   public function get(int $lineNo): ?int {
-    return $this->_lineExecutionState->get($lineNo);
+
+    if ($lineNo < 0 || $lineNo >= strlen($this->_lineExecutionState)) {
+      return null;
+    }
+
+    $packed = ord($this->_lineExecutionState[$lineNo]);
+
+    if ($packed === 0) {
+      return null;
+    }
+
+    return $packed - self::STATE_OFFSET;
+
   }
 
   public function set(int $lineNo, int $lineState): void {
@@ -98,6 +186,10 @@ class LineExecutionState {
       return;
     }
 
+    if ($lineNo < 0) {
+      return;
+    }
+
     // after init is called, we don't let you go backwards to set not
     //   exec | not executed
     // if ($this->_didInit === true &&
@@ -106,11 +198,11 @@ class LineExecutionState {
     //   return;
     // }
 
-    $currentValue = $this->_lineExecutionState->get($lineNo);
+    $currentValue = $this->get($lineNo);
 
     if ($currentValue === null) {
       // no value at all for the stack.
-      $this->_lineExecutionState->set($lineNo, $lineState);
+      $this->store($lineNo, $lineState);
       return;
     }
 
@@ -134,12 +226,190 @@ class LineExecutionState {
       return;
     }
 
-    $this->_lineExecutionState->set($lineNo, $lineState);
+    $this->store($lineNo, $lineState);
+
+  }
+
+  // --
+  // Marks a line as executed along with every line of the executable ranges
+  // it triggers.
+  // --
+  public function markExecuted(int $lineNo): void {
+    $this->markExecutedLines(Vector {$lineNo});
+  }
+
+  // --
+  // Bulk version of markExecuted().
+  //
+  // Each triggered range is only expanded once however many of the lines
+  // trigger it. As line states never drop back from executed, a range that
+  // has been expanded once stays applied and is skipped on later calls too.
+  // --
+  public function markExecutedLines(Traversable<int> $lineNos): void {
+
+    $triggered = Map {};
+
+    foreach ($lineNos as $lineNo) {
+
+      $this->raiseToExecuted($lineNo);
+
+      if ($this->_appliedRanges->count() == $this->_ranges->count()) {
+        continue;
+      }
+
+      foreach ($this->findRangeOffsets($lineNo, false) as $offset) {
+        if ($this->_appliedRanges->containsKey($offset) !== true) {
+          $triggered->set($offset, true);
+        }
+      }
+
+    }
+
+    foreach ($triggered->keys() as $offset) {
+      $range = $this->_ranges[$offset];
+      $end = $range->getEnd();
+      for ($innerLine = $range->getStart(); $innerLine <= $end; $innerLine++) {
+        $this->raiseToExecuted($innerLine);
+      }
+      $this->_appliedRanges->set($offset, true);
+    }
 
   }
 
   public function getAll(): Map<int, int> {
-    return $this->_lineExecutionState;
+
+    $data = Map {};
+
+    $lineCount = strlen($this->_lineExecutionState);
+
+    for ($lineNo = 0; $lineNo < $lineCount; $lineNo++) {
+      $packed = ord($this->_lineExecutionState[$lineNo]);
+      if ($packed !== 0) {
+        $data->set($lineNo, $packed - self::STATE_OFFSET);
+      }
+    }
+
+    return $data;
+
+  }
+
+  // --
+  // set($lineNo, Driver::LINE_EXECUTED) without the validation, executed is
+  // the highest state so only unset, or not executed lines move.
+  // --
+  private function raiseToExecuted(int $lineNo): void {
+
+    if ($lineNo < 0) {
+      return;
+    }
+
+    $currentValue = $this->get($lineNo);
+
+    if ($currentValue === Driver::LINE_EXECUTED ||
+        $currentValue === Driver::LINE_NOT_EXECUTABLE) {
+      return;
+    }
+
+    $this->store($lineNo, Driver::LINE_EXECUTED);
+
+  }
+
+  private function store(int $lineNo, int $lineState): void {
+
+    $length = strlen($this->_lineExecutionState);
+
+    if ($lineNo >= $length) {
+      $this->_lineExecutionState .= str_repeat("\0", $lineNo - $length + 1);
+    }
+
+    $this->_lineExecutionState[$lineNo] =
+      chr($lineState + self::STATE_OFFSET);
+
+  }
+
+  private function sortRanges(): void {
+
+    $offsets = $this->_ranges->keys()->toArray();
+    $firstLines = $this->_rangeFirstLines;
+
+    usort(
+      $offsets,
+      function(int $a, int $b): int use ($firstLines) {
+        if ($firstLines[$a] != $firstLines[$b]) {
+          return $firstLines[$a] - $firstLines[$b];
+        }
+        return $a - $b;
+      },
+    );
+
+    $this->_sortedRanges = new Vector($offsets);
+    $this->_sortedMaxLastLines = Vector {};
+
+    $maxLastLine = PHP_INT_MIN;
+    foreach ($this->_sortedRanges as $offset) {
+      $maxLastLine = max($maxLastLine, $this->_rangeLastLines[$offset]);
+      $this->_sortedMaxLastLines->add($maxLastLine);
+    }
+
+    $this->_isSorted = true;
+
+  }
+
+  // --
+  // Offsets of the ranges applying to $lineNo, in the order they were added.
+  // --
+  private function findRangeOffsets(int $lineNo, bool $firstOnly): Vector<int> {
+
+    $found = Vector {};
+
+    if ($this->_ranges->count() == 0) {
+      return $found;
+    }
+
+    if ($this->_isSorted !== true) {
+      $this->sortRanges();
+    }
+
+    // last sorted position whose first line is at or before $lineNo.
+    $low = 0;
+    $high = $this->_sortedRanges->count() - 1;
+    $last = -1;
+
+    while ($low <= $high) {
+      $mid = ($low + $high) >> 1;
+      if ($this->_rangeFirstLines[$this->_sortedRanges[$mid]] <= $lineNo) {
+        $last = $mid;
+        $low = $mid + 1;
+      } else {
+        $high = $mid - 1;
+      }
+    }
+
+    for ($i = $last; $i >= 0; $i--) {
+
+      if ($this->_sortedMaxLastLines[$i] < $lineNo) {
+        break;
+      }
+
+      $offset = $this->_sortedRanges[$i];
+
+      if ($this->_rangeLastLines[$offset] >= $lineNo) {
+        $found->add($offset);
+        if ($firstOnly === true) {
+          return $found;
+        }
+      }
+
+    }
+
+    if ($found->count() > 1) {
+      $offsets = $found->toArray();
+      sort($offsets);
+      return new Vector($offsets);
+    }
+
+    return $found;
+
   }
 
 }
@@ -0,0 +1,121 @@
+<?hh // strict
+
+namespace Zynga\CodeBase\V1\File;
+
+use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\TestIds;
+
+// --
+// Which tests touched each line, as interned test ids.
+//
+// Each line keeps its ids as a sorted list packed four bytes per id into a
+// string. Tests run one after another so a new id is almost always the
+// largest seen so far and simply gets appended. Names are only looked up when
+// a report asks for them.
+//
+// An append takes the string out of the map first, leaving the local as its
+// only owner so it grows in place instead of being copied whole each time.
+// --
+class LineToTests {
+  const int ID_WIDTH = 4;
+
+  private File $_parent;
+  private Map<int, string> $_lineToTests;
+
+  public function __construct(File $parent) {
+    $this->_parent = $parent;
+    $this->_lineToTests = Map {};
+  }
+
+  public function add(int $lineNo, int $testId): void {
+
+    $packedId = pack('N', $testId);
+
+    $packed = $this->_lineToTests->get($lineNo);
+
+    if ($packed === null) {
+      $this->_lineToTests->set($lineNo, $packedId);
+      return;
+    }
+
+    $count = intval(strlen($packed) / self::ID_WIDTH);
+    $lastId = $this->idAt($packed, $count - 1);
+
+    if ($testId > $lastId) {
+      $this->_lineToTests->remove($lineNo);
+      $packed .= $packedId;
+      $this->_lineToTests->set($lineNo, $packed);
+      return;
+    }
+
+    if ($testId === $lastId) {
+      return;
+    }
+
+    // out of order, find where it belongs keeping the list sorted.
+    $low = 0;
+    $high = $count - 1;
+
+    while ($low <= $high) {
+      $mid = ($low + $high) >> 1;
+      $midId = $this->idAt($packed, $mid);
+      if ($midId === $testId) {
+        return;
+      }
+      if ($midId < $testId) {
+        $low = $mid + 1;
+      } else {
+        $high = $mid - 1;
+      }
+    }
+
+    $this->_lineToTests->set(
+      $lineNo,
+      substr($packed, 0, $low * self::ID_WIDTH).
+      $packedId.
+      substr($packed, $low * self::ID_WIDTH),
+    );
+
+  }
+
+  public function getTestIds(int $lineNo): Vector<int> {
+
+    $testIds = Vector {};
+
+    $packed = $this->_lineToTests->get($lineNo);
+
+    if ($packed === null) {
+      return $testIds;
+    }
+
+    $count = intval(strlen($packed) / self::ID_WIDTH);
+
+    for ($i = 0; $i < $count; $i++) {
+      $testIds->add($this->idAt($packed, $i));
+    }
+
+    return $testIds;
+
+  }
+
+  public function getLines(): Vector<int> {
+    return $this->_lineToTests->keys();
+  }
+
+  public function getTestNames(int $lineNo): Vector<string> {
+    $names = Vector {};
+    foreach ($this->getTestIds($lineNo) as $testId) {
+      $names->add(TestIds::getName($testId));
+    }
+    return $names;
+  }
+
+  private function idAt(string $packed, int $offset): int {
+    $unpacked = unpack(
+      'N',
+      substr($packed, $offset * self::ID_WIDTH, self::ID_WIDTH),
+    );
+    return intval($unpacked[1]);
+  }
+
+}
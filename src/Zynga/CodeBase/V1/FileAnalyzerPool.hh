@@ -0,0 +1,192 @@
+<?hh // strict
+
+namespace Zynga\CodeBase\V1;
+
+use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\FileCache;
+
+// --
+// Runs File::init() for a batch of files across a pool of forked workers.
+//
+// Each worker gets a share of the files balanced by source size, analyzes
+// them and hands the exported analysis back through a temp file. The parent
+// hydrates fresh File objects from those exports, so the caller ends up with
+// the same objects a serial init() would have produced.
+//
+// Without pcntl, or with a single worker, everything is analyzed in process.
+// --
+class FileAnalyzerPool {
+  private int $_workers;
+
+  public function __construct(int $workers) {
+    $this->_workers = $workers;
+  }
+
+  public static function isSupported(): bool {
+    if (function_exists('pcntl_fork') && function_exists('pcntl_waitpid')) {
+      return true;
+    }
+    return false;
+  }
+
+  public function analyze(Vector<string> $filenames): Vector<File> {
+
+    $files = Vector {};
+    $uncached = Vector {};
+
+    // cache hits are cheaper to load here than to ship through a worker.
+    foreach ($filenames as $filename) {
+      $file = new File($filename);
+      $file->source()->load();
+      if (FileCache::load($file) === true) {
+        $files->add($file);
+      } else {
+        $uncached->add($filename);
+      }
+    }
+
+    if ($this->_workers <= 1 ||
+        $uncached->count() <= 1 ||
+        self::isSupported() !== true) {
+      foreach ($uncached as $filename) {
+        $file = new File($filename);
+        $file->init();
+        $files->add($file);
+      }
+      return $files;
+    }
+
+    $children = Map {};
+
+    foreach ($this->partition($uncached) as $chunk) {
+
+      $resultFile = tempnam(sys_get_temp_dir(), 'hh-phpunit-analysis-');
+
+      $pid = pcntl_fork();
+
+      if ($pid == -1) {
+        // could not fork, this chunk is left to the serial fallback.
+        @unlink($resultFile);
+        continue;
+      }
+
+      if ($pid == 0) {
+        $this->runWorker($chunk, $resultFile);
+        exit(0);
+      }
+
+      $children->set($pid, $resultFile);
+
+    }
+
+    foreach ($children as $pid => $resultFile) {
+
+      $status = 0;
+      pcntl_waitpid($pid, $status);
+
+      foreach ($this->readResults($resultFile) as $filename => $analysis) {
+        $file = new File($filename);
+        $file->source()->load();
+        if ($file->hydrate($analysis) === true) {
+          $files->add($file);
+        }
+      }
+
+      @unlink($resultFile);
+
+    }
+
+    return $files;
+
+  }
+
+  // --
+  // Longest processing time first: biggest files go to the least loaded
+  // worker, source size being a good enough proxy for analysis cost.
+  // --
+  private function partition(Vector<string> $filenames): Vector<Vector<string>> {
+
+    $sizes = Map {};
+    foreach ($filenames as $filename) {
+      $sizes->set($filename, intval(@filesize($filename)));
+    }
+
+    $sorted = $sizes->toArray();
+    arsort($sorted);
+
+    $workerCount = min($this->_workers, $filenames->count());
+
+    $chunks = Vector {};
+    $loads = Vector {};
+    for ($i = 0; $i < $workerCount; $i++) {
+      $chunks->add(Vector {});
+      $loads->add(0);
+    }
+
+    foreach ($sorted as $filename => $size) {
+      $target = 0;
+      for ($i = 1; $i < $workerCount; $i++) {
+        if ($loads[$i] < $loads[$target]) {
+          $target = $i;
+        }
+      }
+      $chunks[$target]->add($filename);
+      $loads[$target] = $loads[$target] + $size;
+    }
+
+    return $chunks;
+
+  }
+
+  private function runWorker(Vector<string> $filenames, string $resultFile): void {
+
+    // anything the parent had buffered would otherwise be flushed twice.
+    while (ob_get_level() > 0) {
+      ob_end_clean();
+    }
+
+    $results = array();
+
+    foreach ($filenames as $filename) {
+      $file = new File($filename);
+      $file->init();
+      $results[$filename] = $file->analysis()->export();
+    }
+
+    file_put_contents($resultFile, serialize($results));
+
+  }
+
+  private function readResults(
+    string $resultFile,
+  ): array<string, array<string, mixed>> {
+
+    $results = array();
+
+    if (!is_file($resultFile)) {
+      return $results;
+    }
+
+    $payload = file_get_contents($resultFile);
+
+    if (!is_string($payload) || $payload == '') {
+      return $results;
+    }
+
+    $data = unserialize($payload);
+
+    if (!is_array($data)) {
+      return $results;
+    }
+
+    foreach ($data as $filename => $analysis) {
+      if (is_array($analysis)) {
+        $results[strval($filename)] = $analysis;
+      }
+    }
+
+    return $results;
+
+  }
+
+}
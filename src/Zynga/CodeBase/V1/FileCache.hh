@@ -0,0 +1,144 @@
+<?hh // strict
+
+namespace Zynga\CodeBase\V1;
+
+use Zynga\CodeBase\V1\File;
+
+// --
+// Persistent on-disk cache of File::init() results. Entries are keyed by the
+// file path, the sha1 of the source and the analyzer version, so any edit to
+// the file or to the analysis code invalidates them.
+//
+// Bump ANALYZER_VERSION whenever the token stream or the line execution
+// analysis changes what it produces.
+// --
+class FileCache {
+  const string ANALYZER_VERSION = '2';
+
+  private static string $cacheDir = '';
+
+  public static function setCacheDir(string $cacheDir): void {
+    self::$cacheDir = $cacheDir;
+  }
+
+  public static function getCacheDir(): string {
+    return self::$cacheDir;
+  }
+
+  public static function isEnabled(): bool {
+    if (self::$cacheDir == '') {
+      return false;
+    }
+    return true;
+  }
+
+  public static function getCacheFile(File $file): string {
+    return
+      self::$cacheDir.DIRECTORY_SEPARATOR.sha1($file->getFile()).'.cache';
+  }
+
+  public static function getContentHash(File $file): string {
+    return sha1($file->source()->get());
+  }
+
+  public static function load(File $file): bool {
+
+    if (self::isEnabled() !== true) {
+      return false;
+    }
+
+    $cacheFile = self::getCacheFile($file);
+
+    if (!is_file($cacheFile)) {
+      return false;
+    }
+
+    $payload = file_get_contents($cacheFile);
+
+    if (!is_string($payload) || $payload == '') {
+      return false;
+    }
+
+    $entry = unserialize($payload);
+
+    if (!is_array($entry)) {
+      return false;
+    }
+
+    if (!array_key_exists('version', $entry) ||
+        !array_key_exists('file', $entry) ||
+        !array_key_exists('hash', $entry) ||
+        !array_key_exists('analysis', $entry)) {
+      return false;
+    }
+
+    if ($entry['version'] !== self::ANALYZER_VERSION ||
+        $entry['file'] !== $file->getFile() ||
+        $entry['hash'] !== self::getContentHash($file)) {
+      return false;
+    }
+
+    $analysis = $entry['analysis'];
+
+    if (!is_array($analysis)) {
+      return false;
+    }
+
+    return $file->hydrate($analysis);
+
+  }
+
+  public static function save(File $file): bool {
+
+    if (self::isEnabled() !== true) {
+      return false;
+    }
+
+    if (!is_dir(self::$cacheDir)) {
+      @mkdir(self::$cacheDir, 0755, true);
+    }
+
+    if (!is_dir(self::$cacheDir) || !is_writeable(self::$cacheDir)) {
+      return false;
+    }
+
+    $entry = array(
+      'version' => self::ANALYZER_VERSION,
+      'file' => $file->getFile(),
+      'hash' => self::getContentHash($file),
+      'analysis' => $file->analysis()->export(),
+    );
+
+    $cacheFile = self::getCacheFile($file);
+
+    // write to a temp file then rename, so a concurrent reader never sees a
+    // partially written entry.
+    $tmpFile = $cacheFile.'.'.getmypid().'.tmp';
+
+    if (file_put_contents($tmpFile, serialize($entry)) === false) {
+      return false;
+    }
+
+    return rename($tmpFile, $cacheFile);
+
+  }
+
+  public static function clear(): void {
+
+    if (self::isEnabled() !== true || !is_dir(self::$cacheDir)) {
+      return;
+    }
+
+    $cacheFiles = glob(self::$cacheDir.DIRECTORY_SEPARATOR.'*.cache');
+
+    if (!is_array($cacheFiles)) {
+      return;
+    }
+
+    foreach ($cacheFiles as $cacheFile) {
+      unlink($cacheFile);
+    }
+
+  }
+
+}
@@ -3,6 +3,8 @@
 namespace Zynga\CodeBase\V1;
 
 use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\FileAnalyzerPool;
+use Zynga\CodeBase\V1\TestIds;
 use \Exception;
 
 class FileFactory {
@@ -10,6 +12,7 @@ class FileFactory {
 
   public static function clear(): void {
     self::$files->clear();
+    TestIds::clear();
   }
 
   public static function isFileRegistered(string $filename): bool {
@@ -41,10 +44,61 @@ class FileFactory {
 
   }
 
+  public static function register(File $file): void {
+    self::$files->set($file->getFile(), $file);
+  }
+
+  // --
+  // Drops the analysis of a file that changed on disk, the next get() or
+  // preload() analyzes it again.
+  // --
+  public static function forget(string $filename): void {
+    self::$files->remove($filename);
+  }
+
+  // --
+  // Analyzes every file not yet registered, spreading the work over
+  // $workers forked processes when the runtime allows it. Anything the pool
+  // could not handle falls back to the serial get() path.
+  // --
+  public static function preload(Vector<string> $filenames, int $workers): void {
+
+    $pending = Vector {};
+
+    foreach ($filenames as $filename) {
+      if (self::isFileRegistered($filename) === true) {
+        continue;
+      }
+      if (!is_file($filename)) {
+        continue;
+      }
+      $pending->add($filename);
+    }
+
+    if ($pending->count() == 0) {
+      return;
+    }
+
+    $pool = new FileAnalyzerPool($workers);
+
+    foreach ($pool->analyze($pending) as $file) {
+      self::register($file);
+    }
+
+    foreach ($pending as $filename) {
+      self::get($filename);
+    }
+
+  }
+
   public static function getFileNames(): Vector<string> {
     return self::$files->keys();
   }
 
+  public static function getFileCount(): int {
+    return self::$files->count();
+  }
+
   public static function getAllLineToTestData(
   ): array<string, array<int, array<string>>> {
     $data = array();
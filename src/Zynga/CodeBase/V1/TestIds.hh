@@ -0,0 +1,47 @@
+<?hh // strict
+
+namespace Zynga\CodeBase\V1;
+
+// --
+// Interns test ids into small integers so per line coverage attribution can
+// store ints instead of repeating the full test name for every line.
+// --
+class TestIds {
+  private static Map<string, int> $ids = Map {};
+  private static Vector<string> $names = Vector {};
+
+  public static function clear(): void {
+    self::$ids->clear();
+    self::$names->clear();
+  }
+
+  public static function intern(string $testId): int {
+
+    $id = self::$ids->get($testId);
+
+    if ($id !== null) {
+      return $id;
+    }
+
+    $id = self::$names->count();
+
+    self::$names->add($testId);
+    self::$ids->set($testId, $id);
+
+    return $id;
+
+  }
+
+  public static function getName(int $id): string {
+    $name = self::$names->get($id);
+    if ($name === null) {
+      return '';
+    }
+    return $name;
+  }
+
+  public static function count(): int {
+    return self::$names->count();
+  }
+
+}
@@ -0,0 +1,28 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Exceptions;
+
+use Zynga\PHPUnit\V2\Exceptions\Exception as ExceptionBase;
+use Zynga\PHPUnit\V2\Exceptions\ExceptionWrapper;
+
+// --
+// Stand in for an exception a parallel worker reported but that could not be
+// brought back as itself, keeps the original class name, message and origin
+// so reports still describe the real failure.
+// --
+class ReplayedException extends ExceptionWrapper {
+
+  public function __construct(
+    string $classname,
+    string $message,
+    string $file,
+    int $line,
+  ) {
+    parent::__construct(new ExceptionBase($message));
+
+    $this->classname = $classname;
+    $this->file = $file;
+    $this->line = $line;
+  }
+
+}
@@ -0,0 +1,7 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Exceptions\TestError;
+
+use Zynga\PHPUnit\V2\Exceptions\TestError\RiskyException;
+
+class TimeoutException extends RiskyException {}
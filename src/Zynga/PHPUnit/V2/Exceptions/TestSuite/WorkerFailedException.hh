@@ -0,0 +1,7 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Exceptions\TestSuite;
+
+use Zynga\PHPUnit\V2\Exceptions\Exception;
+
+class WorkerFailedException extends Exception {}
@@ -32,6 +32,26 @@ class FileLoader {
    */
   public static function checkAndLoad(string $filename): Vector<string> {
 
+    $includePathFilename = self::resolve($filename);
+
+    $newClasses = self::load($includePathFilename);
+
+    return $newClasses;
+
+  }
+
+  /**
+   * Resolves a PHP sourcefile against the include path and checks it is
+   * readable.
+   *
+   * @param string $filename
+   *
+   * @return string
+   *
+   * @throws FailedToLoadFileException
+   */
+  public static function resolve(string $filename): string {
+
     $includePathFilename = stream_resolve_include_path($filename);
 
     if (!is_readable($includePathFilename)) {
@@ -40,10 +60,18 @@ class FileLoader {
       );
     }
 
-    $newClasses = self::load($includePathFilename);
+    return $includePathFilename;
 
-    return $newClasses;
+  }
 
+  /**
+   * Includes a PHP sourcefile whose classes are already known, skipping
+   * the declared classes bookkeeping of load().
+   *
+   * @param string $filename
+   */
+  public static function includeFile(string $filename): void {
+    include_once $filename;
   }
 
   /**
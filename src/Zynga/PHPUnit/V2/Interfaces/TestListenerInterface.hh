@@ -12,6 +12,7 @@ namespace Zynga\PHPUnit\V2\Interfaces;
  */
 
 use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 use \Exception;
 
 /**
@@ -129,6 +130,17 @@ interface TestListenerInterface {
    */
   public function startTest(TestInterface $test): void;
 
+  /**
+   * The resources a test used, reported just before it ends.
+   *
+   * @param TestCase    $test
+   * @param TestProfile $profile
+   */
+  public function addTestProfile(
+    TestInterface $test,
+    TestProfile $profile,
+  ): void;
+
   /**
    * A test ended.
    *
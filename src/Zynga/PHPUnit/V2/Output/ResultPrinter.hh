@@ -18,6 +18,7 @@ use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
 use Zynga\PHPUnit\V2\TestCase;
 use Zynga\PHPUnit\V2\TestFailure;
 use Zynga\PHPUnit\V2\TestResult;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 use Zynga\PHPUnit\V2\TestSuite;
 use Zynga\PHPUnit\V2\Output\Printer;
 
@@ -78,6 +79,9 @@ class ResultPrinter extends Printer implements TestListenerInterface {
   private int $_slowTestMax;
   private int $_slowTestDisplayMax;
   private Map<string, int> $_slowTests;
+  // the _slowTestDisplayMax costliest tests so far, costliest first
+  private Vector<(string, TestProfile)> $_slowestProfiles;
+  private Vector<(string, TestProfile)> $_heaviestProfiles;
 
   /**
    * Constructor.
@@ -123,6 +127,8 @@ class ResultPrinter extends Printer implements TestListenerInterface {
     $this->_slowTestMax = 10; // 10ms by default.
     $this->_slowTestDisplayMax = 10; // only show 10 tests at max
     $this->_slowTests = Map {};
+    $this->_slowestProfiles = Vector {};
+    $this->_heaviestProfiles = Vector {};
 
   }
 
@@ -480,6 +486,10 @@ class ResultPrinter extends Printer implements TestListenerInterface {
 
     }
 
+    if ($this->debug || $this->verbose) {
+      $this->printProfileSummary();
+    }
+
     $color = '';
 
     if ($result->wasSuccessful() &&
@@ -527,7 +537,7 @@ class ResultPrinter extends Printer implements TestListenerInterface {
         }
       }
 
-      $this->writeCountString($this->numTests, 'Tests', $color, true);
+      $this->writeCountString($result->count(), 'Tests', $color, true);
 
       $this->writeCountString(
         $this->numAssertions,
@@ -550,6 +560,67 @@ class ResultPrinter extends Printer implements TestListenerInterface {
 
   }
 
+  /**
+   * Prints the tests that took the most cpu time and the most memory.
+   */
+  protected function printProfileSummary(): void {
+
+    if ($this->_slowestProfiles->count() == 0) {
+      return;
+    }
+
+    $this->printProfileList(
+      sprintf('Slowest %d tests by cpu time', $this->_slowTestDisplayMax),
+      $this->_slowestProfiles->toArray(),
+    );
+
+    $this->printProfileList(
+      sprintf('Heaviest %d tests by peak memory', $this->_slowTestDisplayMax),
+      $this->_heaviestProfiles->toArray(),
+    );
+
+    $this->printSeperator();
+
+    $this->writeNewLine();
+
+  }
+
+  private function printProfileList(
+    string $title,
+    array<(string, TestProfile)> $profiles,
+  ): void {
+
+    $this->write("\n".$title."\n");
+
+    $i = 0;
+
+    foreach ($profiles as $entry) {
+
+      list($testName, $profile) = $entry;
+
+      $i++;
+
+      if ($i > $this->_slowTestDisplayMax) {
+        break;
+      }
+
+      $this->write(
+        sprintf(
+          " %4d. %6dms wall %6dms cpu %8.2fMB peak %+8.2fMB delta %4d assertions %s\n",
+          $i,
+          $this->toMilliseconds($profile->getWallTime()),
+          $this->toMilliseconds($profile->getCpuTime()),
+          $profile->getPeakMemory() / 1048576,
+          $profile->getMemoryDelta() / 1048576,
+          $profile->getAssertions(),
+          $testName,
+        ),
+      );
+
+    }
+
+  }
+
   /**
    */
   public function printWaitPrompt(): void {
@@ -736,6 +807,9 @@ class ResultPrinter extends Printer implements TestListenerInterface {
    * @since Method available since Release 2.2.0
    */
   public function startTestSuite(TestInterface $suite): void {
+    // an estimate: deferred data providers count as the data sets of their
+    // last run, or as one test, until they have run. The summary reports the
+    // tests that actually ran.
     if ($this->numTests == -1) {
       $this->numTests = $suite->count();
     }
@@ -789,6 +863,11 @@ class ResultPrinter extends Printer implements TestListenerInterface {
       $this->_slowTests->set($testName, $elapsedMS);
     }
 
+    // data providers can yield more than the suite counted for them.
+    if ($this->numTestsRun > $this->numTests) {
+      $this->numTests = $this->numTestsRun;
+    }
+
     $this->writeWithColor(
       $color,
       date('r').
@@ -804,6 +883,83 @@ class ResultPrinter extends Printer implements TestListenerInterface {
 
   }
 
+  /**
+   * The resources a test used.
+   *
+   * @param TestInterface $test
+   * @param TestProfile   $profile
+   */
+  public function addTestProfile(
+    TestInterface $test,
+    TestProfile $profile,
+  ): void {
+
+    // the summary is only printed for debug or verbose runs.
+    if ($this->debug !== true && $this->verbose !== true) {
+      return;
+    }
+
+    $entry = tuple(get_class($test).'::'.$test->getName(), $profile);
+
+    $this->keepCostliest(
+      $this->_slowestProfiles,
+      $entry,
+      $profile->getCpuTime(),
+      function((string, TestProfile) $kept): float {
+        return $kept[1]->getCpuTime();
+      },
+    );
+
+    $this->keepCostliest(
+      $this->_heaviestProfiles,
+      $entry,
+      floatval($profile->getPeakMemory()),
+      function((string, TestProfile) $kept): float {
+        return floatval($kept[1]->getPeakMemory());
+      },
+    );
+
+  }
+
+  // --
+  // Inserts the entry in cost order when it ranks among the
+  // _slowTestDisplayMax costliest, dropping whatever falls off the end. The
+  // list never grows past that bound however many tests run.
+  // --
+  private function keepCostliest(
+    Vector<(string, TestProfile)> $costliest,
+    (string, TestProfile) $entry,
+    float $cost,
+    (function((string, TestProfile)): float) $costOf,
+  ): void {
+
+    $count = $costliest->count();
+
+    if ($count >= $this->_slowTestDisplayMax &&
+        $cost <= $costOf($costliest[$count - 1])) {
+      return;
+    }
+
+    $position = $count;
+
+    while ($position > 0 && $costOf($costliest[$position - 1]) < $cost) {
+      $position--;
+    }
+
+    $costliest->add($entry);
+
+    for ($i = $count; $i > $position; $i--) {
+      $costliest[$i] = $costliest[$i - 1];
+    }
+
+    $costliest[$position] = $entry;
+
+    if ($costliest->count() > $this->_slowTestDisplayMax) {
+      $costliest->pop();
+    }
+
+  }
+
   /**
    * A test ended.
    *
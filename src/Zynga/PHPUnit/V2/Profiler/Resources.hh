@@ -0,0 +1,60 @@
+<?hh
+
+namespace Zynga\PHPUnit\V2\Profiler;
+
+// --
+// CPU and memory readings for profiling a single test.
+//
+// Peak memory is measured over an interval when the runtime supports it
+// (hhvm's hphp_memory_*_interval), otherwise it falls back to the peak of the
+// whole process so far.
+// --
+class Resources {
+
+  // --
+  // User plus system cpu seconds used by this process.
+  // --
+  public static function getCpuTime(): float {
+
+    if (!function_exists('getrusage')) {
+      return 0.0;
+    }
+
+    $usage = getrusage();
+
+    if (!is_array($usage)) {
+      return 0.0;
+    }
+
+    return
+      intval($usage['ru_utime.tv_sec']) +
+      intval($usage['ru_utime.tv_usec']) / 1000000 +
+      intval($usage['ru_stime.tv_sec']) +
+      intval($usage['ru_stime.tv_usec']) / 1000000;
+
+  }
+
+  public static function getMemoryUsage(): int {
+    return memory_get_usage();
+  }
+
+  public static function startPeakInterval(): void {
+    if (function_exists('hphp_memory_start_interval')) {
+      hphp_memory_start_interval();
+    }
+  }
+
+  public static function stopPeakInterval(): int {
+
+    if (function_exists('hphp_memory_get_interval_peak_usage') &&
+        function_exists('hphp_memory_stop_interval')) {
+      $peak = hphp_memory_get_interval_peak_usage();
+      hphp_memory_stop_interval();
+      return intval($peak);
+    }
+
+    return memory_get_peak_usage();
+
+  }
+
+}
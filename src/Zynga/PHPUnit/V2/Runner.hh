@@ -2,6 +2,7 @@
 
 namespace Zynga\PHPUnit\V2;
 
+use Zynga\CodeBase\V1\FileCache;
 use Zynga\PHPUnit\V2\RunnerPartialShim;
 use Zynga\PHPUnit\V2\Version;
 
@@ -75,6 +76,20 @@ class Runner {
     $argStack->add('--coverage-html='.$this->htmlDir);
     $argStack->add('--coverage-text');
     $argStack->add('--configuration='.$this->projectRoot.'/phpunit.xml');
+    $argStack->add(
+      '--discovery-index='.
+      $this->getTmpDir().
+      '/'.
+      $this->userName.
+      '-hh-phpunit-discovery.idx',
+    );
+    $argStack->add(
+      '--result-cache='.
+      $this->getTmpDir().
+      '/'.
+      $this->userName.
+      '-hh-phpunit-results.cache',
+    );
 
     for ($i = 1; $i < $this->argv->count(); $i++) {
 
@@ -115,6 +130,11 @@ class Runner {
       );
     }
 
+    // analyzed source files are cached across runs, keyed by content hash.
+    FileCache::setCacheDir(
+      $this->getTmpDir().'/'.$this->userName.'-hh-phpunit-codebase-cache',
+    );
+
     // now we force our testErrors into our error_log file
     $testErrorLogFile = $this->projectRoot.'/tmp/php.log';
 
@@ -0,0 +1,435 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2;
+
+use Zynga\CodeBase\V1\FileFactory;
+use Zynga\Framework\ReflectionCache\V1\ReflectionClasses;
+use Zynga\PHPUnit\V2\Annotations;
+use Zynga\PHPUnit\V2\Runner;
+use Zynga\PHPUnit\V2\RunnerPartialShim;
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\Version;
+
+use \Exception;
+
+// --
+// Keeps a runner warm between test runs.
+//
+// The daemon loads the framework classes, fills the reflection and
+// annotation caches for them and analyzes every whitelisted source file once
+// up front. It then listens on a unix socket and forks a child per request,
+// the child inherits all of that and only has to load and run the tests it
+// was asked for. Anything a run changes dies with its child, so every request
+// starts from the same clean state.
+//
+// Test classes are never loaded by the daemon itself, edits to tests are
+// picked up on the next request. Whitelisted sources are re-analyzed when
+// their mtime moves, phpunit.xml is re-read when it changes.
+//
+// A request is a single json line: {"cwd": <dir>, "argv": [<args>]}, or
+// {"command": "stop"}. Everything the run prints is streamed back on the same
+// connection, followed by EXIT_MARKER and the exit code of the run.
+// --
+class RunnerDaemon {
+  const string EXIT_MARKER = "\0hh-phpunit-exit=";
+  const float ACCEPT_TIMEOUT = 1.0;
+
+  private static Vector<string> $_warmClasses = Vector {
+    'PHPUnit_TextUI_Command',
+    'PHPUnit_TextUI_TestRunner',
+    'PHPUnit_TextUI_ResultPrinter',
+    'PHPUnit_Util_Configuration',
+    'PHPUnit_Util_Log_JUnit',
+    'SebastianBergmann\CodeCoverage\CodeCoverage',
+    'SebastianBergmann\CodeCoverage\Filter',
+    'SebastianBergmann\CodeCoverage\Report\Html\Facade',
+    'SebastianBergmann\CodeCoverage\Report\Text',
+    'Zynga\PHPUnit\V2\FileLoader',
+    'Zynga\PHPUnit\V2\TestCase',
+    'Zynga\PHPUnit\V2\TestResult',
+    'Zynga\PHPUnit\V2\TestSuite',
+    'Zynga\PHPUnit\V2\TestSuite\ParallelRunner',
+  };
+
+  private string $_projectRoot;
+  private string $_userName;
+  private string $_socketPath;
+  private int $_workers;
+
+  private int $_configTime;
+  private Vector<string> $_whitelist;
+  private Map<string, int> $_fileTimes;
+  private Map<int, bool> $_children;
+
+  public function __construct(
+    string $projectRoot,
+    string $userName,
+    string $socketPath,
+    int $workers,
+  ) {
+    $this->_projectRoot = $projectRoot;
+    $this->_userName = $userName;
+    $this->_socketPath = $socketPath;
+    $this->_workers = max(1, $workers);
+    $this->_configTime = 0;
+    $this->_whitelist = Vector {};
+    $this->_fileTimes = Map {};
+    $this->_children = Map {};
+  }
+
+  public static function getDefaultSocketPath(
+    string $projectRoot,
+    string $userName,
+  ): string {
+    return $projectRoot.'/tmp/'.$userName.'-hh-phpunit.sock';
+  }
+
+  public static function isSupported(): bool {
+    if (function_exists('pcntl_fork') &&
+        function_exists('pcntl_waitpid') &&
+        function_exists('stream_socket_server')) {
+      return true;
+    }
+    return false;
+  }
+
+  public function run(): int {
+
+    try {
+
+      $this->message('Zynga-PHPUnit-Daemon Version: '.Version::get());
+
+      if (self::isSupported() !== true) {
+        return $this->failure('pcntl and stream sockets are required');
+      }
+
+      $this->warmUp();
+
+      return $this->serve();
+
+    } catch (Exception $e) {
+      return
+        $this->failure($e->getMessage().' backtrace='.$e->getTraceAsString());
+    }
+
+  }
+
+  private function warmUp(): void {
+
+    $startTime = microtime(true);
+
+    // sets up the tmp dir, codebase cache and error log the children share.
+    $runner = new Runner($this->_projectRoot, $this->_userName, array());
+    $runner->init();
+
+    foreach (self::$_warmClasses as $className) {
+      if (class_exists($className, true) !== true) {
+        continue;
+      }
+      ReflectionClasses::getReflection($className);
+    }
+
+    Annotations::parseClassAnnotations(TestCase::class);
+
+    $this->refreshCodeBase();
+
+    $this->message(
+      'warm files='.
+      $this->_fileTimes->count().
+      ' elapsed='.
+      sprintf('%0.3f', microtime(true) - $startTime),
+    );
+
+  }
+
+  // --
+  // Re-reads phpunit.xml when it moved and re-analyzes any whitelisted file
+  // whose mtime changed since the last request.
+  // --
+  private function refreshCodeBase(): void {
+
+    $configFile = $this->_projectRoot.'/phpunit.xml';
+
+    if (!is_file($configFile)) {
+      return;
+    }
+
+    clearstatcache();
+
+    $configTime = intval(filemtime($configFile));
+
+    if ($configTime != $this->_configTime) {
+      $this->_configTime = $configTime;
+      $this->_whitelist =
+        RunnerPartialShim::getConfiguredWhitelist($configFile);
+    }
+
+    $changed = Vector {};
+
+    foreach ($this->_whitelist as $fileName) {
+
+      $fileTime = is_file($fileName) ? intval(filemtime($fileName)) : 0;
+
+      if ($this->_fileTimes->get($fileName) === $fileTime) {
+        continue;
+      }
+
+      FileFactory::forget($fileName);
+
+      $this->_fileTimes->set($fileName, $fileTime);
+      $changed->add($fileName);
+
+    }
+
+    if ($changed->count() > 0) {
+      FileFactory::preload($changed, $this->_workers);
+    }
+
+  }
+
+  private function serve(): int {
+
+    if (file_exists($this->_socketPath)) {
+      @unlink($this->_socketPath);
+    }
+
+    $errorNumber = 0;
+    $errorString = '';
+
+    // requests pick the arguments and directory of the run, only the
+    // daemon's own user gets to send them.
+    $oldMask = umask(0077);
+
+    $server = stream_socket_server(
+      'unix://'.$this->_socketPath,
+      $errorNumber,
+      $errorString,
+    );
+
+    umask($oldMask);
+
+    if (!is_resource($server)) {
+      return $this->failure(
+        'could not listen socket='.
+        $this->_socketPath.
+        ' error='.
+        $errorString,
+      );
+    }
+
+    if (!chmod($this->_socketPath, 0600)) {
+      fclose($server);
+      @unlink($this->_socketPath);
+      return $this->failure('could not restrict socket='.$this->_socketPath);
+    }
+
+    $this->message('listening socket='.$this->_socketPath);
+
+    while (true) {
+
+      $this->reapChildren(false);
+
+      $connection = @stream_socket_accept($server, self::ACCEPT_TIMEOUT);
+
+      if (!is_resource($connection)) {
+        continue;
+      }
+
+      $request = $this->readRequest($connection);
+
+      if ($request === null) {
+        fclose($connection);
+        continue;
+      }
+
+      if (strval(idx($request, 'command')) === 'stop') {
+        fwrite($connection, self::EXIT_MARKER."0\n");
+        fclose($connection);
+        break;
+      }
+
+      $argv = self::getRequestArgv($request);
+
+      if ($argv === null) {
+        fwrite(
+          $connection,
+          'argv must be an array of strings'."\n".self::EXIT_MARKER."255\n",
+        );
+        fclose($connection);
+        continue;
+      }
+
+      $this->refreshCodeBase();
+
+      $pid = pcntl_fork();
+
+      if ($pid == -1) {
+        fwrite($connection, 'could not fork'."\n".self::EXIT_MARKER."255\n");
+        fclose($connection);
+        continue;
+      }
+
+      if ($pid == 0) {
+        fclose($server);
+        exit($this->handleRequest($connection, $request, $argv));
+      }
+
+      fclose($connection);
+
+      $this->_children->set($pid, true);
+
+    }
+
+    fclose($server);
+    @unlink($this->_socketPath);
+
+    $this->reapChildren(true);
+
+    $this->message('stopped');
+
+    return 0;
+
+  }
+
+  private function readRequest(resource $connection): ?array<string, mixed> {
+
+    $line = fgets($connection);
+
+    if (!is_string($line)) {
+      return null;
+    }
+
+    $request = json_decode($line, true);
+
+    if (!is_array($request)) {
+      return null;
+    }
+
+    return $request;
+
+  }
+
+  // --
+  // The argv of a run request, null unless it is an array of strings.
+  // --
+  public static function getRequestArgv(
+    array<string, mixed> $request,
+  ): ?Vector<string> {
+
+    $argv = idx($request, 'argv');
+
+    if (!is_array($argv)) {
+      return null;
+    }
+
+    $args = Vector {};
+
+    foreach ($argv as $arg) {
+      if (!is_string($arg)) {
+        return null;
+      }
+      $args->add($arg);
+    }
+
+    return $args;
+
+  }
+
+  // --
+  // Runs in the forked child, streams the run's output back on the
+  // connection.
+  //
+  // PHPUnit_TextUI_Command exit()s on its own for bad options, --version,
+  // --list-groups and the like, so the run itself goes into one more child
+  // and its exit status is taken from pcntl_waitpid() rather than from run()
+  // returning. A run that exits early or dies still reports its real status.
+  // --
+  private function handleRequest(
+    resource $connection,
+    array<string, mixed> $request,
+    Vector<string> $argv,
+  ): int {
+
+    while (ob_get_level() > 0) {
+      ob_end_clean();
+    }
+
+    $pid = pcntl_fork();
+
+    if ($pid == -1) {
+      fwrite($connection, 'could not fork'."\n".self::EXIT_MARKER."255\n");
+      fclose($connection);
+      return 255;
+    }
+
+    if ($pid == 0) {
+      exit($this->runRequest($connection, $request, $argv));
+    }
+
+    $status = 0;
+    $exitCode = 255;
+
+    if (pcntl_waitpid($pid, $status) == $pid && pcntl_wifexited($status)) {
+      $exitCode = pcntl_wexitstatus($status);
+    }
+
+    fwrite($connection, self::EXIT_MARKER.$exitCode."\n");
+    fclose($connection);
+
+    return $exitCode;
+
+  }
+
+  private function runRequest(
+    resource $connection,
+    array<string, mixed> $request,
+    Vector<string> $argv,
+  ): int {
+
+    ob_start(
+      function(string $buffer): string use ($connection) {
+        fwrite($connection, $buffer);
+        return '';
+      },
+      1,
+    );
+
+    $cwd = strval(idx($request, 'cwd'));
+
+    if ($cwd != '' && is_dir($cwd)) {
+      chdir($cwd);
+    }
+
+    $runner =
+      new Runner($this->_projectRoot, $this->_userName, $argv->toArray());
+
+    $exitCode = $runner->run();
+
+    ob_end_flush();
+
+    return $exitCode;
+
+  }
+
+  private function reapChildren(bool $wait): void {
+
+    foreach ($this->_children->keys() as $pid) {
+      $status = 0;
+      $options = $wait === true ? 0 : WNOHANG;
+      if (pcntl_waitpid($pid, $status, $options) != 0) {
+        $this->_children->remove($pid);
+      }
+    }
+
+  }
+
+  public function failure(string $message): int {
+    $this->message('FAILURE - '.$message);
+    return 255;
+  }
+
+  public function message(string $message): void {
+    print date('r').' - '.$message."\n";
+  }
+
+}
@@ -0,0 +1,83 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\RunnerDaemon;
+
+use Zynga\PHPUnit\V2\RunnerDaemon;
+
+// --
+// Splits what a daemon connection streams back into the run's output and
+// its exit code.
+//
+// The output is handed on as it arrives, apart from a tail as long as
+// RunnerDaemon::EXIT_MARKER held back so a marker split over reads is still
+// recognized. Everything from the marker on is kept for finish().
+// --
+class OutputReader {
+  private string $_pending;
+  private bool $_sawMarker;
+
+  public function __construct() {
+    $this->_pending = '';
+    $this->_sawMarker = false;
+  }
+
+  // --
+  // Takes the next chunk read off the connection, returns the output that
+  // can be printed now.
+  // --
+  public function feed(string $chunk): string {
+
+    if ($this->_sawMarker === true) {
+      $this->_pending .= $chunk;
+      return '';
+    }
+
+    $this->_pending .= $chunk;
+
+    $markerAt = strpos($this->_pending, RunnerDaemon::EXIT_MARKER);
+
+    if ($markerAt !== false) {
+      $output = substr($this->_pending, 0, $markerAt);
+      $this->_pending = substr($this->_pending, $markerAt);
+      $this->_sawMarker = true;
+      return $output;
+    }
+
+    $markerLength = strlen(RunnerDaemon::EXIT_MARKER);
+
+    if (strlen($this->_pending) <= $markerLength) {
+      return '';
+    }
+
+    $output = substr($this->_pending, 0, -$markerLength);
+    $this->_pending = substr($this->_pending, -$markerLength);
+
+    return $output;
+
+  }
+
+  // --
+  // Once the connection closed: the output still held back and the exit
+  // code, null when the run ended without reporting one.
+  // --
+  public function finish(): (string, ?int) {
+
+    $pending = $this->_pending;
+    $this->_pending = '';
+
+    if ($this->_sawMarker !== true) {
+      return tuple($pending, null);
+    }
+
+    $exitCode =
+      trim(substr($pending, strlen(RunnerDaemon::EXIT_MARKER)));
+
+    if ($exitCode === '' || !ctype_digit($exitCode)) {
+      return tuple('', null);
+    }
+
+    return tuple('', intval($exitCode));
+
+  }
+
+}
@@ -2,7 +2,9 @@
 
 namespace Zynga\PHPUnit\V2;
 
+use SebastianBergmann\CodeCoverage\Filter;
 use \PHPUnit_TextUI_Command;
+use \PHPUnit_Util_Configuration;
 
 class RunnerPartialShim {
   public static function runPHPUnit(bool $return, array $argv): int {
@@ -10,4 +12,49 @@ class RunnerPartialShim {
     var_dump($argv);
     return PHPUnit_TextUI_Command::main(false, $argv);
   }
+
+  // --
+  // The whitelisted source files of a phpunit.xml, resolved the way
+  // TestRunner does when coverage is collected.
+  // --
+  public static function getConfiguredWhitelist(
+    string $configFile,
+  ): Vector<string> {
+
+    PHPUnit_Util_Configuration::forgetInstance($configFile);
+
+    $configuration = PHPUnit_Util_Configuration::getInstance($configFile);
+    $filterConfiguration = $configuration->getFilterConfiguration();
+    $whitelist = $filterConfiguration['whitelist'];
+
+    $filter = new Filter();
+
+    foreach ($whitelist['include']['directory'] as $dir) {
+      $filter->addDirectoryToWhitelist(
+        $dir['path'],
+        $dir['suffix'],
+        $dir['prefix'],
+      );
+    }
+
+    foreach ($whitelist['include']['file'] as $file) {
+      $filter->addFileToWhitelist($file);
+    }
+
+    foreach ($whitelist['exclude']['directory'] as $dir) {
+      $filter->removeDirectoryFromWhitelist(
+        $dir['path'],
+        $dir['suffix'],
+        $dir['prefix'],
+      );
+    }
+
+    foreach ($whitelist['exclude']['file'] as $file) {
+      $filter->removeFileFromWhitelist($file);
+    }
+
+    return new Vector($filter->getWhitelist());
+
+  }
+
 }
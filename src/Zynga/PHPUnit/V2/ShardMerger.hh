@@ -0,0 +1,120 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2;
+
+use Zynga\CodeBase\V1\CoverageBaseline;
+
+use \DOMDocument;
+use \DOMElement;
+
+// --
+// Combines what the shards of a --shard run wrote out into a single set of
+// results.
+//
+// JUnit logs are joined under one top level testsuite per name, with the
+// counters summed up. Shards split by class so the testcases never overlap.
+//
+// Coverage is exchanged through the coverage baseline each shard records
+// with --coverage-baseline. The merged baseline holds the attribution of
+// every shard. Running --coverage-incremental against it finds nothing
+// changed, runs nothing and renders the reports for the whole suite.
+// --
+class ShardMerger {
+  private static Vector<string> $_summedAttributes =
+    Vector {'tests', 'assertions', 'failures', 'errors'};
+
+  public function mergeJUnit(Vector<string> $logFiles, string $outputFile): bool {
+
+    $merged = new DOMDocument('1.0', 'UTF-8');
+    $merged->formatOutput = true;
+
+    $root = $merged->createElement('testsuites');
+    $merged->appendChild($root);
+
+    // top level suite name => merged element
+    $suites = Map {};
+
+    foreach ($logFiles as $logFile) {
+
+      $document = new DOMDocument();
+
+      if (!is_file($logFile) || $document->load($logFile) !== true) {
+        return false;
+      }
+
+      $documentRoot = $document->documentElement;
+
+      if (!$documentRoot instanceof DOMElement) {
+        continue;
+      }
+
+      foreach ($documentRoot->childNodes as $node) {
+
+        if (!$node instanceof DOMElement || $node->tagName !== 'testsuite') {
+          continue;
+        }
+
+        $name = $node->getAttribute('name');
+
+        $target = $suites->get($name);
+
+        if (!$target instanceof DOMElement) {
+          $imported = $merged->importNode($node, true);
+          if ($imported instanceof DOMElement) {
+            $root->appendChild($imported);
+            $suites->set($name, $imported);
+          }
+          continue;
+        }
+
+        foreach (self::$_summedAttributes as $attribute) {
+          $target->setAttribute(
+            $attribute,
+            strval(
+              intval($target->getAttribute($attribute)) +
+              intval($node->getAttribute($attribute)),
+            ),
+          );
+        }
+
+        $target->setAttribute(
+          'time',
+          sprintf(
+            '%F',
+            floatval($target->getAttribute('time')) +
+            floatval($node->getAttribute('time')),
+          ),
+        );
+
+        foreach ($node->childNodes as $child) {
+          $target->appendChild($merged->importNode($child, true));
+        }
+
+      }
+
+    }
+
+    return $merged->save($outputFile) !== false;
+
+  }
+
+  public function mergeCoverage(
+    Vector<string> $baselineFiles,
+    string $outputFile,
+  ): bool {
+
+    $merged = new CoverageBaseline($outputFile);
+
+    foreach ($baselineFiles as $baselineFile) {
+      $shardBaseline = new CoverageBaseline($baselineFile);
+      if ($shardBaseline->load() !== true) {
+        return false;
+      }
+      $merged->merge($shardBaseline);
+    }
+
+    return $merged->saveMerged();
+
+  }
+
+}
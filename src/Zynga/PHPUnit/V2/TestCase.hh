@@ -20,6 +20,8 @@ use Zynga\PHPUnit\V2\Test\Requirements;
 use Zynga\PHPUnit\V2\TestCase\OutputBuffer;
 use Zynga\PHPUnit\V2\TestCase\Size;
 use Zynga\PHPUnit\V2\TestCase\Status;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
+use Zynga\PHPUnit\V2\TestSuite\DataProvider\LazyRunner;
 use Zynga\PHPUnit\V2\Exceptions\TestSuite\TestCaseExtensionException;
 
 // JEO: needs conversion.
@@ -69,6 +71,14 @@ abstract class TestCase extends Assertions implements TestInterface {
   private bool $_hasDependencies;
   private Vector<mixed> $_data;
   private string $_dataName;
+  // stands in for the data sets of its provider until it runs
+  private bool $_isLazyDataProvider;
+  // data sets the provider yielded once run, -1 before
+  private int $_providedTestCount;
+  // data sets the provider yielded last time, -1 when never seen
+  private int $_expectedTestCount;
+  // what the last run of this test cost, null before it ran
+  private ?TestProfile $_profile;
   private PerformanceTracker $_perf;
 
   public function __construct(
@@ -104,6 +114,10 @@ abstract class TestCase extends Assertions implements TestInterface {
     }
     $this->_data = $v_data;
     $this->_dataName = $dataName;
+    $this->_isLazyDataProvider = false;
+    $this->_providedTestCount = -1;
+    $this->_expectedTestCount = -1;
+    $this->_profile = null;
 
     $this->_name = $name;
     $this->_perf = new PerformanceTracker();
@@ -170,12 +184,51 @@ abstract class TestCase extends Assertions implements TestInterface {
   /**
    * Counts the number of test cases executed by run(TestResult result).
    *
+   * A test standing in for a deferred data provider counts as the data sets
+   * its provider yielded last time until it has run, or as one when that is
+   * not known.
+   *
    * @return int
    */
   final public function count(): int {
+    if ($this->_providedTestCount >= 0) {
+      return $this->_providedTestCount;
+    }
+    if ($this->_isLazyDataProvider === true && $this->_expectedTestCount >= 0) {
+      return $this->_expectedTestCount;
+    }
     return 1;
   }
 
+  /**
+   * Marks the test as standing in for the data sets of its data provider,
+   * the provider is only called once the test runs.
+   *
+   * @param bool $isLazy
+   */
+  final public function setLazyDataProvider(bool $isLazy): void {
+    $this->_isLazyDataProvider = $isLazy;
+  }
+
+  final public function isLazyDataProvider(): bool {
+    return $this->_isLazyDataProvider;
+  }
+
+  final public function setProvidedTestCount(int $count): void {
+    $this->_providedTestCount = $count;
+  }
+
+  final public function setExpectedTestCount(int $count): void {
+    $this->_expectedTestCount = $count;
+  }
+
+  /**
+   * Drops the data set once the test is done with it.
+   */
+  final public function releaseData(): void {
+    $this->_data = Vector {};
+  }
+
   /**
    * @return string
    *
@@ -193,6 +246,14 @@ abstract class TestCase extends Assertions implements TestInterface {
     return $this->_outputBuffer->getOutputLine();
   }
 
+  final public function restoreOutput(
+    string $output,
+    string $file,
+    int $line,
+  ): void {
+    $this->_outputBuffer->restore($output, $file, $line);
+  }
+
   /**
    * @since Method available since Release 4.2.0
    */
@@ -769,6 +830,24 @@ abstract class TestCase extends Assertions implements TestInterface {
     return $this->_numAssertions;
   }
 
+  /**
+   * Sets the resource profile of the last run of this test.
+   *
+   * @param ?TestProfile $profile
+   */
+  final public function setProfile(?TestProfile $profile): void {
+    $this->_profile = $profile;
+  }
+
+  /**
+   * Returns the resource profile of the last run of this test.
+   *
+   * @return ?TestProfile
+   */
+  final public function getProfile(): ?TestProfile {
+    return $this->_profile;
+  }
+
   /**
    * @since Method available since Release 3.6.0
    */
@@ -974,6 +1053,10 @@ abstract class TestCase extends Assertions implements TestInterface {
       $result = $this->getResult();
     }
 
+    if ($this->_isLazyDataProvider === true) {
+      return LazyRunner::run($this, $result);
+    }
+
     // WarningTestCase is probably dead now that Mocks are dead.
     // if (!$this instanceof PHPUnit_Framework_WarningTestCase) {
     $this->setUseErrorHandlerFromAnnotation();
@@ -1170,6 +1253,11 @@ abstract class TestCase extends Assertions implements TestInterface {
       $this->endBareTimer();
       $this->status()
         ->setMessageAndCode($e->getMessage(), Status::STATUS_WARNING);
+    } catch (RiskyException $e) {
+      // a TimeoutException from the watchdog lands here.
+      $this->endBareTimer();
+      $this->status()
+        ->setMessageAndCode($e->getMessage(), Status::STATUS_RISKY);
     } catch (AssertionFailedException $e) {
       $this->endBareTimer();
       $this->status()
@@ -29,6 +29,15 @@ class OutputBuffer {
     return $this->_line;
   }
 
+  // --
+  // Puts back output captured by another process, see TestSuite\ParallelRunner.
+  // --
+  public function restore(string $output, string $file, int $line): void {
+    $this->_output = $output;
+    $this->_file = $file;
+    $this->_line = $line;
+  }
+
   /**
    * @since Method available since Release 4.2.0
    */
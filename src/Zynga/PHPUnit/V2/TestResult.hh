@@ -22,9 +22,14 @@ use Zynga\PHPUnit\V2\Exceptions\TestError\SkippedException;
 use Zynga\PHPUnit\V2\IncompleteTestCase;
 use Zynga\PHPUnit\V2\Interfaces\TestInterface;
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
+use Zynga\PHPUnit\V2\Profiler\Resources;
 use Zynga\PHPUnit\V2\Profiler\XDebug;
 use Zynga\PHPUnit\V2\TestResult\Listeners;
+use Zynga\PHPUnit\V2\TestResult\Recorder;
 use Zynga\PHPUnit\V2\TestResult\TestFailures;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
+use Zynga\PHPUnit\V2\TestResult\Watchdog;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
 use Zynga\PHPUnit\V2\TestCase\Size;
 use Zynga\PHPUnit\V2\Exceptions\ExceptionWrapper;
 use Zynga\PHPUnit\V2\WarningTestCase;
@@ -71,6 +76,9 @@ class TestResult {
   private bool $_convertErrorsToExceptions;
   private bool $_errorHandlerSet;
   private mixed $_errorHandlerPrevious;
+  private int $_workers;
+  private ?Recorder $_recorder;
+  private ?TimingDatabase $_timingDatabase;
 
   public function __construct() {
     $this->_listeners = new Listeners();
@@ -99,6 +107,9 @@ class TestResult {
     $this->_convertErrorsToExceptions = true;
     $this->_errorHandlerSet = false;
     $this->_errorHandlerPrevious = null;
+    $this->_workers = 1;
+    $this->_recorder = null;
+    $this->_timingDatabase = null;
   }
 
   public function listeners(): Listeners {
@@ -117,6 +128,62 @@ class TestResult {
     $this->_listeners->flush();
   }
 
+  /**
+   * Swaps out the listeners, returning the ones that were attached.
+   *
+   * @param Listeners $listeners
+   *
+   * @return Listeners
+   */
+  public function setListeners(Listeners $listeners): Listeners {
+    $previous = $this->_listeners;
+    $this->_listeners = $listeners;
+    return $previous;
+  }
+
+  /**
+   * Sets the number of forked workers test suites are run across.
+   *
+   * @param int $workers
+   */
+  public function setWorkers(int $workers): void {
+    if ($workers < 1) {
+      $workers = 1;
+    }
+    $this->_workers = $workers;
+  }
+
+  public function getWorkers(): int {
+    return $this->_workers;
+  }
+
+  /**
+   * Records every test event from here on, used by parallel workers to ship
+   * their results back.
+   *
+   * @param ?Recorder $recorder
+   */
+  public function setRecorder(?Recorder $recorder): void {
+    $this->_recorder = $recorder;
+  }
+
+  public function getRecorder(): ?Recorder {
+    return $this->_recorder;
+  }
+
+  /**
+   * Records the time of every test that ends into the timing database.
+   *
+   * @param ?TimingDatabase $timingDatabase
+   */
+  public function setTimingDatabase(?TimingDatabase $timingDatabase): void {
+    $this->_timingDatabase = $timingDatabase;
+  }
+
+  public function getTimingDatabase(): ?TimingDatabase {
+    return $this->_timingDatabase;
+  }
+
   /**
    * Returns whether the entire test was successful or not.
    *
@@ -299,6 +366,9 @@ class TestResult {
     Exception $e,
     float $time,
   ): void {
+    if ($this->_recorder instanceof Recorder) {
+      $this->_recorder->addError($test, $e, $time);
+    }
     $this->_testFailures->handleTestFailures($this, $test, $e, $time, false);
   }
 
@@ -317,6 +387,9 @@ class TestResult {
     Exception $e,
     float $time,
   ): void {
+    if ($this->_recorder instanceof Recorder) {
+      $this->_recorder->addWarning($test, $e, $time);
+    }
     $this->_testFailures->handleWarningTestFailure($this, $test, $e, $time);
   }
 
@@ -333,6 +406,9 @@ class TestResult {
     Exception $e,
     float $time,
   ): void {
+    if ($this->_recorder instanceof Recorder) {
+      $this->_recorder->addFailure($test, $e, $time);
+    }
     // if ( preg_match('/Requirements/', get_class($test))) {
     // var_dump($test->getName());
     // var_dump(get_class($test));
@@ -628,6 +704,29 @@ class TestResult {
     return $this->_timeoutForLargeTests;
   }
 
+  /**
+   * Returns the time limit for a test by its size, tests without a size get
+   * the limit of large tests.
+   *
+   * @param TestCase $test
+   * @return int
+   */
+  final public function getTimeoutForTest(TestCase $test): int {
+
+    $size = $test->getSize();
+
+    if ($size == Size::SMALL) {
+      return $this->_timeoutForSmallTests;
+    }
+
+    if ($size == Size::MEDIUM) {
+      return $this->_timeoutForMediumTests;
+    }
+
+    return $this->_timeoutForLargeTests;
+
+  }
+
   /**
    * @param bool $flag
    *
@@ -683,6 +782,10 @@ class TestResult {
    */
   final public function startTest(TestInterface $test): void {
 
+    if ($this->_recorder instanceof Recorder) {
+      $this->_recorder->startTest($test);
+    }
+
     $this->setLastTestFailed(false);
     $this->incrementRunTest($test->count());
     $this->listeners()->startTest($test);
@@ -696,8 +799,24 @@ class TestResult {
    * @param float                  $time
    */
   final public function endTest(TestInterface $test, float $time): void {
+    if ($this->_recorder instanceof Recorder) {
+      $this->_recorder->endTest($test, $time);
+    }
+
+    if ($test instanceof TestCase) {
+      $profile = $test->getProfile();
+      if ($profile instanceof TestProfile) {
+        $this->listeners()->addTestProfile($test, $profile);
+      }
+    }
+
     $this->listeners()->endTest($test, $time);
 
+    if ($this->_timingDatabase instanceof TimingDatabase &&
+        $test instanceof TestCase) {
+      $this->_timingDatabase->record($test->getClass(), $test->getName(), $time);
+    }
+
     if (!$this->getLastTestFailed() && $test instanceof TestCase) {
       $class = $test->getClass();
       $key = $class.'::'.$test->getName();
@@ -854,6 +973,10 @@ class TestResult {
 
     $this->startTest($test);
 
+    $cpuTimeStart = Resources::getCpuTime();
+    $memoryStart = Resources::getMemoryUsage();
+    Resources::startPeakInterval();
+
     $monitorFunctions =
       $this->isStrictAboutResourceUsageDuringSmallTests() &&
       !$test instanceof PHPUnit_Framework_WarningTestCase &&
@@ -864,6 +987,15 @@ class TestResult {
       XDebug::startMonitoringFunctions(ResourceOperations::getFunctions());
     }
 
+    $watchdog = null;
+
+    if ($this->_enforceTimeLimit === true &&
+        !$test instanceof PHPUnit_Framework_WarningTestCase &&
+        Watchdog::isSupported()) {
+      $watchdog = new Watchdog($this->getTimeoutForTest($test));
+      $watchdog->start();
+    }
+
     try {
 
       $test->runBare($this);
@@ -908,6 +1040,12 @@ class TestResult {
       // exit();
       $e = new ExceptionWrapper($e);
       $error = true;
+    } finally {
+      // an alarm going off once runBare() returned is still caught above,
+      // nothing past this point can be interrupted by it.
+      if ($watchdog instanceof Watchdog) {
+        $watchdog->stop();
+      }
     }
 
     $time = $test->getBareElapsed();
@@ -915,6 +1053,16 @@ class TestResult {
     // $test->addToAssertionCount(PHPUnit_Framework_Assert::getCount());
     $test->addToAssertionCount($test->getCount());
 
+    $test->setProfile(
+      new TestProfile(
+        $time,
+        Resources::getCpuTime() - $cpuTimeStart,
+        Resources::getMemoryUsage() - $memoryStart,
+        Resources::stopPeakInterval(),
+        $test->getNumAssertions(),
+      ),
+    );
+
     if ($monitorFunctions) {
       $functions = XDebug::getMonitoredFunctions();
 
@@ -5,6 +5,7 @@ namespace Zynga\PHPUnit\V2\TestResult;
 use Zynga\PHPUnit\V2\Interfaces\TestInterface;
 use Zynga\PHPUnit\V2\Interfaces\TestListenerInterface;
 use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 
 use \PHPUnit_Util_Printer;
 use \Exception;
@@ -125,6 +126,15 @@ class Listeners implements TestListenerInterface {
     }
   }
 
+  final public function addTestProfile(
+    TestInterface $test,
+    TestProfile $profile,
+  ): void {
+    foreach ($this->_listeners as $listener) {
+      $listener->addTestProfile($test, $profile);
+    }
+  }
+
   final public function endTest(TestInterface $test, float $time): void {
     foreach ($this->_listeners as $listener) {
       $listener->endTest($test, $time);
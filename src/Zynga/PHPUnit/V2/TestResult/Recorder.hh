@@ -0,0 +1,282 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestResult;
+
+use Zynga\PHPUnit\V2\Exceptions\ReplayedException;
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
+
+use \Exception;
+use \ReflectionClass;
+use \ReflectionProperty;
+
+// --
+// Records what a TestResult was told about each test so another process can
+// tell its own TestResult the same thing later on.
+//
+// Tests are referred to by their position within the plan both processes
+// share, the suite running them being position -1. The data sets of a
+// deferred data provider only exist in the process that ran its stand-in, so
+// each is announced with a data set event and from then on referred to by
+// the stand-in's position and its ordinal within the events handed over
+// together. Events are plain arrays so they serialize, exceptions travel
+// serialized with their trace arguments dropped, falling back to class,
+// message and origin when that fails.
+// --
+class Recorder {
+  const string EVENT_START_TEST = 'startTest';
+  const string EVENT_ADD_ERROR = 'addError';
+  const string EVENT_ADD_FAILURE = 'addFailure';
+  const string EVENT_ADD_WARNING = 'addWarning';
+  const string EVENT_END_TEST = 'endTest';
+  const string EVENT_DATA_SET = 'dataSet';
+
+  const int SUITE_POSITION = -1;
+  const int NO_ORDINAL = -1;
+
+  // spl_object_hash of the test => position within the plan
+  private Map<string, int> $_positions;
+  // spl_object_hash of a data set test => (stand-in position, ordinal)
+  private Map<string, (int, int)> $_dataSets;
+  private Vector<array<mixed>> $_events;
+
+  public function __construct(Map<string, int> $positions) {
+    $this->_positions = $positions;
+    $this->_dataSets = Map {};
+    $this->_events = Vector {};
+  }
+
+  // --
+  // Announces a test created for one of the data sets of the stand-in, so
+  // the process replaying the events can create its own copy.
+  // --
+  public function addDataSetTest(
+    TestCase $standIn,
+    TestInterface $test,
+  ): void {
+
+    $position = $this->_positions->get(spl_object_hash($standIn));
+
+    if ($position === null) {
+      return;
+    }
+
+    $ordinal = $this->_dataSets->count();
+
+    $this->_dataSets->set(spl_object_hash($test), tuple($position, $ordinal));
+
+    $dataName = '';
+    if ($test instanceof TestCase) {
+      $dataName = $test->getDataName();
+    }
+
+    $this->_events->add(
+      array(
+        self::EVENT_DATA_SET,
+        $position,
+        $ordinal,
+        array(get_class($test), $test->getName(), $dataName),
+      ),
+    );
+
+  }
+
+  public function startTest(TestInterface $test): void {
+    $this->record(self::EVENT_START_TEST, $test, array());
+  }
+
+  public function addError(TestInterface $test, Exception $e, float $time): void {
+    $this->record(
+      self::EVENT_ADD_ERROR,
+      $test,
+      array(self::packException($e), $time),
+    );
+  }
+
+  public function addFailure(
+    TestInterface $test,
+    Exception $e,
+    float $time,
+  ): void {
+    $this->record(
+      self::EVENT_ADD_FAILURE,
+      $test,
+      array(self::packException($e), $time),
+    );
+  }
+
+  public function addWarning(
+    TestInterface $test,
+    Exception $e,
+    float $time,
+  ): void {
+    $this->record(
+      self::EVENT_ADD_WARNING,
+      $test,
+      array(self::packException($e), $time),
+    );
+  }
+
+  public function endTest(TestInterface $test, float $time): void {
+
+    $state = array($time);
+
+    // what the printer and loggers read back off the test once it ended.
+    if ($test instanceof TestCase) {
+      $state[] = $test->getStatus();
+      $state[] = $test->getStatusMessage();
+      $state[] = $test->getNumAssertions();
+      $state[] = $test->getActualOutput();
+      $state[] = $test->getOutputFile();
+      $state[] = $test->getOutputLine();
+      $profile = $test->getProfile();
+      $state[] = $profile instanceof TestProfile ? $profile->toArray() : null;
+    }
+
+    $this->record(self::EVENT_END_TEST, $test, $state);
+
+  }
+
+  // --
+  // Hands over everything recorded so far and starts afresh.
+  // --
+  public function takeEvents(): Vector<array<mixed>> {
+    $events = $this->_events;
+    $this->_events = Vector {};
+    $this->_dataSets = Map {};
+    return $events;
+  }
+
+  public static function packException(Exception $e): array<mixed> {
+
+    $serialized = '';
+
+    try {
+      self::dropTraceArguments($e);
+      $serialized = serialize($e);
+    } catch (Exception $serializeFailure) {
+      // closures and resources hiding in properties, the fallback will do.
+      $serialized = '';
+    }
+
+    return array(
+      $serialized,
+      get_class($e),
+      $e->getMessage(),
+      $e->getFile(),
+      $e->getLine(),
+    );
+
+  }
+
+  public static function unpackException(array<mixed> $packed): Exception {
+
+    if (count($packed) != 5) {
+      return new ReplayedException('Exception', '', '', 0);
+    }
+
+    $serialized = strval($packed[0]);
+    $classname = strval($packed[1]);
+    $message = strval($packed[2]);
+    $file = strval($packed[3]);
+    $line = intval($packed[4]);
+
+    if ($serialized != '') {
+      $e = @unserialize($serialized);
+      if ($e instanceof Exception) {
+        return $e;
+      }
+    }
+
+    // same class at least, so the result files it under the same heading.
+    try {
+      if (class_exists($classname, false)) {
+        $reflection = new ReflectionClass($classname);
+        if ($reflection->isSubclassOf(Exception::class)) {
+          $e = $reflection->newInstanceWithoutConstructor();
+          if ($e instanceof Exception) {
+            self::setExceptionProperty($e, 'message', $message);
+            self::setExceptionProperty($e, 'file', $file);
+            self::setExceptionProperty($e, 'line', $line);
+            return $e;
+          }
+        }
+      }
+    } catch (Exception $rebuildFailure) {
+      // fall through to the stand in.
+    }
+
+    return new ReplayedException($classname, $message, $file, $line);
+
+  }
+
+  private function record(
+    string $event,
+    TestInterface $test,
+    array<mixed> $payload,
+  ): void {
+
+    $hash = spl_object_hash($test);
+
+    $position = $this->_positions->get($hash);
+    $ordinal = self::NO_ORDINAL;
+
+    if ($position === null) {
+
+      $dataSet = $this->_dataSets->get($hash);
+
+      if ($dataSet === null) {
+        return;
+      }
+
+      list($position, $ordinal) = $dataSet;
+
+    }
+
+    $this->_events->add(array($event, $position, $ordinal, $payload));
+
+  }
+
+  // --
+  // Arguments are what usually keeps an exception from serializing, they are
+  // not shown in any report so they go for the whole chain.
+  // --
+  private static function dropTraceArguments(Exception $e): void {
+
+    $property = new ReflectionProperty(Exception::class, 'trace');
+    $property->setAccessible(true);
+
+    $current = $e;
+
+    while ($current instanceof Exception) {
+
+      $trace = $property->getValue($current);
+
+      if (is_array($trace)) {
+        foreach ($trace as $frameId => $frame) {
+          if (is_array($frame) && array_key_exists('args', $frame)) {
+            unset($frame['args']);
+            $trace[$frameId] = $frame;
+          }
+        }
+        $property->setValue($current, $trace);
+      }
+
+      $current = $current->getPrevious();
+
+    }
+
+  }
+
+  private static function setExceptionProperty(
+    Exception $e,
+    string $name,
+    mixed $value,
+  ): void {
+    $property = new ReflectionProperty(Exception::class, $name);
+    $property->setAccessible(true);
+    $property->setValue($e, $value);
+  }
+
+}
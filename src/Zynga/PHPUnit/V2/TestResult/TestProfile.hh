@@ -0,0 +1,74 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestResult;
+
+// --
+// What a single test cost to run: wall and cpu seconds, the memory it left
+// allocated, the peak memory while it ran and the assertions it made.
+//
+// TestResult::run() measures it around TestCase::runBare() and hands it to
+// the listeners through TestListenerInterface::addTestProfile() just before
+// endTest().
+// --
+class TestProfile {
+  private float $_wallTime;
+  private float $_cpuTime;
+  private int $_memoryDelta;
+  private int $_peakMemory;
+  private int $_assertions;
+
+  public function __construct(
+    float $wallTime,
+    float $cpuTime,
+    int $memoryDelta,
+    int $peakMemory,
+    int $assertions,
+  ) {
+    $this->_wallTime = $wallTime;
+    $this->_cpuTime = $cpuTime;
+    $this->_memoryDelta = $memoryDelta;
+    $this->_peakMemory = $peakMemory;
+    $this->_assertions = $assertions;
+  }
+
+  public function getWallTime(): float {
+    return $this->_wallTime;
+  }
+
+  public function getCpuTime(): float {
+    return $this->_cpuTime;
+  }
+
+  public function getMemoryDelta(): int {
+    return $this->_memoryDelta;
+  }
+
+  public function getPeakMemory(): int {
+    return $this->_peakMemory;
+  }
+
+  public function getAssertions(): int {
+    return $this->_assertions;
+  }
+
+  public function toArray(): array<string, mixed> {
+    return array(
+      'time' => $this->_wallTime,
+      'cpuTime' => $this->_cpuTime,
+      'memoryDelta' => $this->_memoryDelta,
+      'peakMemory' => $this->_peakMemory,
+      'assertions' => $this->_assertions,
+    );
+  }
+
+  public static function fromArray(array<string, mixed> $data): TestProfile {
+    return new TestProfile(
+      floatval(idx($data, 'time')),
+      floatval(idx($data, 'cpuTime')),
+      intval(idx($data, 'memoryDelta')),
+      intval(idx($data, 'peakMemory')),
+      intval(idx($data, 'assertions')),
+    );
+  }
+
+}
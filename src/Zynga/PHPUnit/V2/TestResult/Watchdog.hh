@@ -0,0 +1,72 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestResult;
+
+use Zynga\PHPUnit\V2\Exceptions\TestError\TimeoutException;
+
+// --
+// Aborts a test that runs past its time limit.
+//
+// SIGALRM is armed for the limit when the test starts. If it goes off, the
+// handler throws a TimeoutException from wherever the test happens to be, and
+// TestCase::runBare() and TestResult::run() report that as a risky test.
+// Code that never returns to the runtime, a blocking call inside an
+// extension, is out of its reach; in parallel runs the parent kills such a
+// worker instead.
+// --
+class Watchdog {
+  private int $_timeout;
+
+  public function __construct(int $timeout) {
+    $this->_timeout = $timeout;
+  }
+
+  public static function isSupported(): bool {
+    if (function_exists('pcntl_signal') && function_exists('pcntl_alarm')) {
+      return true;
+    }
+    return false;
+  }
+
+  public function getTimeout(): int {
+    return $this->_timeout;
+  }
+
+  public function start(): void {
+
+    if ($this->_timeout <= 0) {
+      return;
+    }
+
+    $timeout = $this->_timeout;
+
+    pcntl_signal(
+      SIGALRM,
+      function(int $signal): void use ($timeout) {
+        throw new TimeoutException(
+          sprintf(
+            'Execution aborted after %d second%s',
+            $timeout,
+            $timeout == 1 ? '' : 's',
+          ),
+        );
+      },
+      true,
+    );
+
+    pcntl_alarm($timeout);
+
+  }
+
+  public function stop(): void {
+
+    if ($this->_timeout <= 0) {
+      return;
+    }
+
+    pcntl_alarm(0);
+    pcntl_signal(SIGALRM, SIG_DFL);
+
+  }
+
+}
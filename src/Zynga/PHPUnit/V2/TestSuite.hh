@@ -19,9 +19,13 @@ use Zynga\PHPUnit\V2\Test\Base;
 use Zynga\PHPUnit\V2\Test\Requirements;
 use Zynga\PHPUnit\V2\TestResult;
 use Zynga\PHPUnit\V2\TestSuite\DataProvider;
+use Zynga\PHPUnit\V2\TestSuite\DiscoveryIndex;
+use Zynga\PHPUnit\V2\TestSuite\ExecutionPlan;
 use Zynga\PHPUnit\V2\TestSuite\StaticUtil;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
 use Zynga\PHPUnit\V2\TestSuiteIterator;
 use Zynga\PHPUnit\V2\TestSuite\OnTestClassChangeListener;
+use Zynga\PHPUnit\V2\TestSuite\ParallelRunner;
 use Zynga\PHPUnit\V2\Exceptions\TestSuite\TestCaseNotFoundException;
 use Zynga\PHPUnit\V2\Exceptions\TestSuite\TestMethodHiddenException;
 
@@ -34,6 +38,12 @@ class TestSuite extends Base {
 
   const string SUITE_METHODNAME = 'suite';
 
+  /**
+   * Static index of the test files, consulted instead of including each
+   * file to find out what it declares.
+   */
+  private static ?DiscoveryIndex $_discoveryIndex = null;
+
   /**
    * The name of the test suite.
    *
@@ -51,6 +61,12 @@ class TestSuite extends Base {
    */
   private Map<string, Vector<TestInterface>> $_groups;
 
+  /**
+   * The flattened tests, built on first use and dropped whenever the tests
+   * change.
+   */
+  private ?ExecutionPlan $_plan;
+
   /**
    * @var PHPUnit_Runner_Filter_Factory
    */
@@ -85,6 +101,7 @@ class TestSuite extends Base {
     $this->_name = '';
     $this->_tests = Vector {};
     $this->_groups = Map {};
+    $this->_plan = null;
 
     //$this->_iteratorFilter = null;
 
@@ -272,21 +289,11 @@ class TestSuite extends Base {
 
   final public function count(): int {
 
-    $numTests = 0;
-
-    // foreach ($this->_tests as $test) {
-    //   $numTests += $test->count();
-    // }
-
     // --
     // JEO: We need to support both test count() and testSuite count which
     //      requires iterating to children to find them all.
     // --
-    foreach ($this->getIterator()->getChildren() as $child) {
-      $numTests += $child->count();
-    }
-
-    return $numTests;
+    return $this->getPlan()->count();
 
   }
 
@@ -331,6 +338,123 @@ class TestSuite extends Base {
    */
   final public function setTests(Vector<TestInterface> $tests): void {
     $this->_tests = $tests;
+    $this->_plan = null;
+  }
+
+  /**
+   * Returns the flattened execution plan of the suite.
+   *
+   * @return ExecutionPlan
+   */
+  final public function getPlan(): ExecutionPlan {
+
+    $plan = $this->_plan;
+
+    if ($plan instanceof ExecutionPlan) {
+      return $plan;
+    }
+
+    $plan = new ExecutionPlan($this);
+    $this->_plan = $plan;
+
+    return $plan;
+
+  }
+
+  /**
+   * Drops every test the callback rejects, descending into child suites.
+   * Suites left without any tests are dropped as well.
+   *
+   * @return int the number of tests kept
+   */
+  final public function retainTests(
+    (function(TestInterface): bool) $keep,
+  ): int {
+
+    $kept = Vector {};
+    $keptCount = 0;
+
+    foreach ($this->_tests as $test) {
+      if ($test instanceof TestSuite) {
+        $childCount = $test->retainTests($keep);
+        if ($childCount > 0) {
+          $kept->add($test);
+          $keptCount += $childCount;
+        }
+      } else if ($keep($test) === true) {
+        $kept->add($test);
+        $keptCount++;
+      }
+    }
+
+    $this->_tests = $kept;
+    $this->_plan = null;
+
+    return $keptCount;
+
+  }
+
+  /**
+   * Lets every test standing in for a deferred data provider count as the
+   * data sets its provider yielded in the last run, so totals and shard
+   * weights are right before the providers are called.
+   */
+  final public function setExpectedDataSetCounts(
+    TimingDatabase $timings,
+  ): void {
+
+    foreach ($this->getPlan()->getTests() as $test) {
+
+      if (!$test instanceof TestCase || $test->isLazyDataProvider() !== true) {
+        continue;
+      }
+
+      $count = $timings->getDataSetCount($test->getClass(), $test->getName());
+
+      if ($count !== null) {
+        $test->setExpectedTestCount($count);
+      }
+
+    }
+
+  }
+
+  /**
+   * Calls the deferred data providers of every test in the suite, replacing
+   * each stand-in test with the tests for its data sets. For runners that
+   * need the whole plan up front.
+   */
+  final public function expandLazyDataProviders(): void {
+
+    for ($offset = 0; $offset < $this->_tests->count(); $offset++) {
+
+      $test = $this->_tests[$offset];
+
+      if ($test instanceof TestSuite) {
+        $test->expandLazyDataProviders();
+        continue;
+      }
+
+      if (!$test instanceof TestCase || $test->isLazyDataProvider() !== true) {
+        continue;
+      }
+
+      $class = ReflectionClasses::getReflection($test->getClass());
+
+      if (!$class instanceof ReflectionClass) {
+        continue;
+      }
+
+      $expanded = StaticUtil::createTest_Provided($class, $test->getName());
+      $expanded->setDependenciesFromAnnotation();
+      $expanded->setGroupsFromAnnotation();
+
+      $this->_tests[$offset] = $expanded;
+
+    }
+
+    $this->_plan = null;
+
   }
 
   /**
@@ -355,6 +479,7 @@ class TestSuite extends Base {
     }
 
     $this->_tests->add($test);
+    $this->_plan = null;
 
     // @TODO: looking at not forward porting this value.
     // $this->numTests = -1;
@@ -571,17 +696,6 @@ class TestSuite extends Base {
 
     $result->startTestSuite($this);
 
-    // JEO: Quick get the first and last tests off the stack.
-    $firstTest = null;
-    $lastTest = null;
-
-    foreach ($this->getIterator()->getChildren() as $test) {
-      if ($firstTest === null) {
-        $firstTest = $test;
-      }
-      $lastTest = $test;
-    }
-
     try {
       $this->setUp();
 
@@ -611,7 +725,20 @@ class TestSuite extends Base {
       return $this->suiteFailedMarkAllTestsFailed($result, $e);
     }
 
-    foreach ($this->getIterator()->getChildren() as $test) {
+    if ($result->getWorkers() > 1 && ParallelRunner::isSupported()) {
+
+      $parallelRunner = new ParallelRunner($result->getWorkers());
+      $parallelRunner->run($this, $result);
+
+      $this->tearDown();
+
+      $result->endTestSuite($this);
+
+      return $result;
+
+    }
+
+    foreach ($this->getPlan()->getTests() as $test) {
 
       $didClassChange = OnTestClassChangeListener::isClassChange($test);
 
@@ -705,10 +832,14 @@ class TestSuite extends Base {
 
     // The given file may contain further stub classes in addition to the
     // test class itself. Figure out the actual test class.
-    $newClasses = FileLoader::checkAndLoad($filename);
+    $newClasses = $this->discoverClasses($filename);
 
     foreach ($newClasses as $className) {
 
+      if (class_exists($className, false) !== true) {
+        continue;
+      }
+
       $class = ReflectionClasses::getReflection($className);
 
       if (!$class instanceof ReflectionClass) {
@@ -734,6 +865,49 @@ class TestSuite extends Base {
 
   }
 
+  public static function setDiscoveryIndex(?DiscoveryIndex $index): void {
+    self::$_discoveryIndex = $index;
+  }
+
+  public static function getDiscoveryIndex(): ?DiscoveryIndex {
+    return self::$_discoveryIndex;
+  }
+
+  /**
+   * The classes a test file declares. With a discovery index they come from
+   * the index and files without a concrete class are not included at all,
+   * otherwise the file is included and the newly declared classes returned.
+   *
+   * @param string $filename
+   *
+   * @return Vector<string>
+   */
+  private function discoverClasses(string $filename): Vector<string> {
+
+    $index = self::$_discoveryIndex;
+
+    if (!$index instanceof DiscoveryIndex) {
+      return FileLoader::checkAndLoad($filename);
+    }
+
+    $includePathFilename = FileLoader::resolve($filename);
+
+    $classes = $index->getClasses($includePathFilename);
+
+    if ($classes === null) {
+      return FileLoader::load($includePathFilename);
+    }
+
+    if ($index->needsInclude($includePathFilename) !== true) {
+      return Vector {};
+    }
+
+    FileLoader::includeFile($includePathFilename);
+
+    return $classes;
+
+  }
+
   /**
    * Wrapper for addTestFile() that adds multiple test files.
    *
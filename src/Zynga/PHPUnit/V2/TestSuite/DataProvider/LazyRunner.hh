@@ -0,0 +1,159 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestSuite\DataProvider;
+
+use Zynga\Framework\ReflectionCache\V1\ReflectionClasses;
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestCase\Status;
+use Zynga\PHPUnit\V2\TestResult;
+use Zynga\PHPUnit\V2\TestResult\Recorder;
+use Zynga\PHPUnit\V2\TestSuite;
+use Zynga\PHPUnit\V2\TestSuite\StaticUtil;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
+
+use \Iterator;
+use \ReflectionClass;
+
+// --
+// Runs the data sets of a test whose data provider was deferred until now.
+//
+// The provider is called once the test comes up in the run. A provider
+// returning a generator or iterator is consumed one data set at a time: each
+// set becomes a test, runs and is let go before the next one is pulled. An
+// array is expanded the way it always was, the tests are then handed out one
+// at a time so each is freed as soon as it ran. Tests that passed drop their
+// data right away; failures keep theirs for the report.
+//
+// How many data sets a provider yielded is kept in the timing database, the
+// next run counts the stand-in as that many tests before it runs.
+// --
+class LazyRunner {
+
+  public static function run(
+    TestCase $placeholder,
+    TestResult $result,
+  ): TestResult {
+
+    $theClass = ReflectionClasses::getReflection($placeholder->getClass());
+    $name = $placeholder->getName();
+
+    $data = null;
+
+    if ($theClass instanceof ReflectionClass) {
+      $data = StaticUtil::createTest_LoadData($theClass, $name);
+    }
+
+    if (!$theClass instanceof ReflectionClass || $data == null) {
+      // nothing was provided, it runs as a plain test.
+      $placeholder->setLazyDataProvider(false);
+      return $placeholder->run($result);
+    }
+
+    $count = 0;
+
+    if ($data instanceof Iterator) {
+
+      foreach ($data as $dataName => $dataSet) {
+
+        if ($result->shouldStop()) {
+          break;
+        }
+
+        $test = StaticUtil::createDataSetTest(
+          $theClass,
+          $name,
+          strval($dataName),
+          $dataSet,
+        );
+
+        self::runDataSet($placeholder, $test, $result);
+        $count++;
+
+      }
+
+      self::recordCount($placeholder, $result, $count);
+
+      return $result;
+
+    }
+
+    $provided = StaticUtil::createViaProvidedData($theClass, $name, $data);
+    $data = null;
+
+    $pending = Vector {$provided};
+
+    if ($provided instanceof TestSuite) {
+      $pending = $provided->getIterator()->getChildren();
+      $provided->setTests(Vector {});
+    }
+
+    $pending->reverse();
+
+    while ($pending->count() > 0) {
+
+      if ($result->shouldStop()) {
+        break;
+      }
+
+      self::runDataSet($placeholder, $pending->pop(), $result);
+      $count++;
+
+    }
+
+    self::recordCount($placeholder, $result, $count);
+
+    return $result;
+
+  }
+
+  private static function recordCount(
+    TestCase $placeholder,
+    TestResult $result,
+    int $count,
+  ): void {
+
+    $placeholder->setProvidedTestCount($count);
+
+    $timings = $result->getTimingDatabase();
+
+    // a stopped run never saw every data set.
+    if ($timings instanceof TimingDatabase && !$result->shouldStop()) {
+      $timings->recordDataSetCount(
+        $placeholder->getClass(),
+        $placeholder->getName(),
+        $count,
+      );
+    }
+
+  }
+
+  private static function runDataSet(
+    TestCase $placeholder,
+    TestInterface $test,
+    TestResult $result,
+  ): void {
+
+    $test->setDependencies($placeholder->getDependencies());
+
+    if ($test instanceof TestCase) {
+      $test->setGroups($placeholder->getGroups());
+    }
+
+    // parallel workers ship the data set's events back to the parent.
+    $recorder = $result->getRecorder();
+
+    if ($recorder instanceof Recorder) {
+      $recorder->addDataSetTest($placeholder, $test);
+    }
+
+    $test->run($result);
+
+    if ($test instanceof TestCase &&
+        $test->status()->getCode() == Status::STATUS_PASSED) {
+      $test->releaseData();
+    }
+
+  }
+
+}
@@ -0,0 +1,240 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestSuite;
+
+use Zynga\CodeBase\V1\File;
+
+// --
+// What every test file declares, found by scanning its tokens instead of
+// including it.
+//
+// Each file maps to the concrete classes it declares. Which of their methods
+// are tests is left to reflection once the file is in, a class may inherit
+// all of them. Entries are kept by mtime, a file whose mtime moved is hashed
+// and only scanned again when its content actually changed.
+//
+// TestSuite::addTestFile() consults it so files that declare no concrete
+// class are never compiled, and the classes of the others are known without
+// diffing get_declared_classes() around the include.
+// --
+class DiscoveryIndex {
+  const string FORMAT_VERSION = '2';
+
+  private string $_indexFile;
+
+  // file => (mtime, sha1, concrete classes, declares functions)
+  private Map<string, (int, string, Vector<string>, bool)> $_entries;
+
+  private bool $_isDirty;
+
+  public function __construct(string $indexFile) {
+    $this->_indexFile = $indexFile;
+    $this->_entries = Map {};
+    $this->_isDirty = false;
+  }
+
+  public function getIndexFile(): string {
+    return $this->_indexFile;
+  }
+
+  public function load(): bool {
+
+    if (!is_file($this->_indexFile)) {
+      return false;
+    }
+
+    $payload = file_get_contents($this->_indexFile);
+
+    if (!is_string($payload) || $payload == '') {
+      return false;
+    }
+
+    $data = unserialize($payload);
+
+    if (!is_array($data) ||
+        !array_key_exists('version', $data) ||
+        $data['version'] !== self::FORMAT_VERSION ||
+        !array_key_exists('files', $data) ||
+        !is_array($data['files'])) {
+      return false;
+    }
+
+    foreach ($data['files'] as $fileName => $entry) {
+
+      if (!is_array($entry) || !is_array($entry['classes'])) {
+        continue;
+      }
+
+      $classes = Vector {};
+
+      foreach ($entry['classes'] as $className) {
+        $classes->add(strval($className));
+      }
+
+      $this->_entries->set(
+        strval($fileName),
+        tuple(
+          intval($entry['mtime']),
+          strval($entry['hash']),
+          $classes,
+          boolval($entry['functions']),
+        ),
+      );
+
+    }
+
+    return true;
+
+  }
+
+  // --
+  // The concrete classes the file declares, null when the file cannot be
+  // read.
+  // --
+  public function getClasses(string $fileName): ?Vector<string> {
+
+    $entry = $this->getEntry($fileName);
+
+    if ($entry === null) {
+      return null;
+    }
+
+    return $entry[2];
+
+  }
+
+  // --
+  // Whether including the file can contribute anything: a concrete class
+  // to look at or functions the tests might rely on.
+  // --
+  public function needsInclude(string $fileName): bool {
+
+    $entry = $this->getEntry($fileName);
+
+    if ($entry === null) {
+      return true;
+    }
+
+    list($mtime, $hash, $classes, $declaresFunctions) = $entry;
+
+    if ($classes->count() > 0 || $declaresFunctions === true) {
+      return true;
+    }
+
+    return false;
+
+  }
+
+  public function isDirty(): bool {
+    return $this->_isDirty;
+  }
+
+  private function getEntry(
+    string $fileName,
+  ): ?(int, string, Vector<string>, bool) {
+
+    if (!is_readable($fileName)) {
+      return null;
+    }
+
+    $mtime = intval(filemtime($fileName));
+
+    $entry = $this->_entries->get($fileName);
+
+    if ($entry !== null && $entry[0] === $mtime) {
+      return $entry;
+    }
+
+    $hash = sha1_file($fileName);
+
+    if ($entry !== null && $entry[1] === $hash) {
+      // touched but not edited, the scan still holds.
+      $entry = tuple($mtime, $entry[1], $entry[2], $entry[3]);
+    } else {
+      list($classes, $declaresFunctions) = $this->scan($fileName);
+      $entry = tuple($mtime, strval($hash), $classes, $declaresFunctions);
+    }
+
+    $this->_entries->set($fileName, $entry);
+    $this->_isDirty = true;
+
+    return $entry;
+
+  }
+
+  private function scan(string $fileName): (Vector<string>, bool) {
+
+    $file = new File($fileName);
+    $file->source()->load();
+
+    // the stream runs the parser, which fills in the classes.
+    $file->stream();
+
+    $classes = Vector {};
+
+    foreach ($file->classes()->getAll() as $name => $class) {
+
+      if (strpos($class->keywords, 'abstract') !== false) {
+        continue;
+      }
+
+      $namespace = strval($class->package->get('namespace'));
+
+      $className = $name;
+
+      if ($namespace != '') {
+        $className = $namespace.'\\'.$name;
+      }
+
+      $classes->add($className);
+
+    }
+
+    $declaresFunctions = $file->functions()->getAll()->count() > 0;
+
+    return tuple($classes, $declaresFunctions);
+
+  }
+
+  public function save(): bool {
+
+    $files = array();
+
+    foreach ($this->_entries as $fileName => $entry) {
+
+      list($mtime, $hash, $classes, $declaresFunctions) = $entry;
+
+      $files[$fileName] = array(
+        'mtime' => $mtime,
+        'hash' => $hash,
+        'classes' => $classes->toArray(),
+        'functions' => $declaresFunctions,
+      );
+
+    }
+
+    $data = array('version' => self::FORMAT_VERSION, 'files' => $files);
+
+    $indexDir = dirname($this->_indexFile);
+
+    if (!is_dir($indexDir)) {
+      @mkdir($indexDir, 0755, true);
+    }
+
+    $tmpFile = $this->_indexFile.'.'.getmypid().'.tmp';
+
+    if (file_put_contents($tmpFile, serialize($data)) === false) {
+      return false;
+    }
+
+    if (rename($tmpFile, $this->_indexFile) !== true) {
+      return false;
+    }
+
+    $this->_isDirty = false;
+
+    return true;
+
+  }
+
+}
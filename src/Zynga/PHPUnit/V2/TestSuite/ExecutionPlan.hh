@@ -0,0 +1,207 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestSuite;
+
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestSuite;
+
+// --
+// The tests of a suite flattened into the order they run in, built in one
+// walk of the suite tree.
+//
+// Alongside the tests it records where one class ends and the next begins
+// and which positions each group holds, both the groups the tests carry and
+// those a suite files its tests under. TestSuite keeps a plan until its
+// tests change, so running, counting, listing, scheduling and sharding all
+// share one walk rather than each doing their own.
+//
+// count() is summed on each call: a test with a deferred data provider
+// counts as the data sets of its last run, or one when that is not known,
+// until it ran and as its data sets after.
+// --
+class ExecutionPlan {
+  private ImmVector<TestInterface> $_tests;
+  // first and last position of each run of tests sharing a class
+  private ImmVector<(int, int)> $_classRanges;
+  private ImmMap<string, ImmVector<int>> $_groups;
+
+  public function __construct(TestSuite $suite) {
+
+    $tests = Vector {};
+    $this->flatten($suite, $tests);
+
+    $classRanges = Vector {};
+    $groups = Map {};
+
+    $rangeStart = 0;
+    $currentClass = '';
+
+    foreach ($tests as $position => $test) {
+
+      $className = get_class($test);
+
+      if ($position > 0 && $className !== $currentClass) {
+        $classRanges->add(tuple($rangeStart, $position - 1));
+        $rangeStart = $position;
+      }
+
+      $currentClass = $className;
+
+      foreach ($test->getGroups() as $group) {
+        $this->addGroupPosition($groups, $group, $position);
+      }
+
+    }
+
+    if ($tests->count() > 0) {
+      $classRanges->add(tuple($rangeStart, $tests->count() - 1));
+    }
+
+    // the suites keep groups of their own, 'default' for the tests added
+    // without one, which the tests themselves do not carry.
+    $positionsByHash = Map {};
+    foreach ($tests as $position => $test) {
+      $positionsByHash->set(spl_object_hash($test), $position);
+    }
+
+    $this->addSuiteGroups($suite, $positionsByHash, $groups);
+
+    $immutableGroups = Map {};
+    foreach ($groups as $group => $positionSet) {
+      $positions = $positionSet->keys()->toArray();
+      sort($positions);
+      $immutableGroups->set($group, new ImmVector($positions));
+    }
+
+    $this->_tests = $tests->toImmVector();
+    $this->_classRanges = $classRanges->toImmVector();
+    $this->_groups = $immutableGroups->toImmMap();
+
+  }
+
+  private function flatten(TestSuite $suite, Vector<TestInterface> $tests): void {
+    foreach ($suite->tests() as $test) {
+      if ($test instanceof TestSuite) {
+        $this->flatten($test, $tests);
+      } else {
+        $tests->add($test);
+      }
+    }
+  }
+
+  private function addGroupPosition(
+    Map<string, Map<int, bool>> $groups,
+    string $group,
+    int $position,
+  ): void {
+    $positions = $groups->get($group);
+    if ($positions === null) {
+      $positions = Map {};
+      $groups->set($group, $positions);
+    }
+    $positions->set($position, true);
+  }
+
+  private function addSuiteGroups(
+    TestSuite $suite,
+    Map<string, int> $positionsByHash,
+    Map<string, Map<int, bool>> $groups,
+  ): void {
+
+    foreach ($suite->getGroupDetails() as $group => $groupTests) {
+
+      // a group may hold no test at all, it is still listed.
+      if (!$groups->containsKey($group)) {
+        $groups->set($group, Map {});
+      }
+
+      foreach ($groupTests as $groupTest) {
+
+        $leafTests = Vector {};
+
+        if ($groupTest instanceof TestSuite) {
+          $this->flatten($groupTest, $leafTests);
+        } else {
+          $leafTests->add($groupTest);
+        }
+
+        foreach ($leafTests as $leafTest) {
+          $position = $positionsByHash->get(spl_object_hash($leafTest));
+          if ($position !== null) {
+            $this->addGroupPosition($groups, $group, $position);
+          }
+        }
+
+      }
+
+    }
+
+    foreach ($suite->tests() as $test) {
+      if ($test instanceof TestSuite) {
+        $this->addSuiteGroups($test, $positionsByHash, $groups);
+      }
+    }
+
+  }
+
+  public function getTests(): ImmVector<TestInterface> {
+    return $this->_tests;
+  }
+
+  public function getTestCount(): int {
+    return $this->_tests->count();
+  }
+
+  public function count(): int {
+    $count = 0;
+    foreach ($this->_tests as $test) {
+      $count += $test->count();
+    }
+    return $count;
+  }
+
+  public function getFirstTest(): ?TestInterface {
+    return $this->_tests->get(0);
+  }
+
+  public function getLastTest(): ?TestInterface {
+    return $this->_tests->get($this->_tests->count() - 1);
+  }
+
+  // --
+  // Plan positions cut into runs of consecutive tests sharing a class.
+  // --
+  public function getClassGroups(): Vector<Vector<int>> {
+
+    $classGroups = Vector {};
+
+    foreach ($this->_classRanges as $range) {
+      list($first, $last) = $range;
+      $positions = Vector {};
+      for ($position = $first; $position <= $last; $position++) {
+        $positions->add($position);
+      }
+      $classGroups->add($positions);
+    }
+
+    return $classGroups;
+
+  }
+
+  public function getClassRanges(): ImmVector<(int, int)> {
+    return $this->_classRanges;
+  }
+
+  public function getGroupNames(): ImmVector<string> {
+    return $this->_groups->keys();
+  }
+
+  public function getGroupPositions(string $group): ImmVector<int> {
+    $positions = $this->_groups->get($group);
+    if ($positions === null) {
+      return ImmVector {};
+    }
+    return $positions;
+  }
+
+}
@@ -0,0 +1,893 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestSuite;
+
+use SebastianBergmann\CodeCoverage\CodeCoverage;
+use SebastianBergmann\CodeCoverage\Driver;
+use Zynga\Framework\ReflectionCache\V1\ReflectionClasses;
+use Zynga\CodeBase\V1\FileFactory;
+use Zynga\PHPUnit\V2\Exceptions\TestError\TimeoutException;
+use Zynga\PHPUnit\V2\Exceptions\TestSuite\WorkerFailedException;
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestResult;
+use Zynga\PHPUnit\V2\TestResult\Listeners;
+use Zynga\PHPUnit\V2\TestResult\Recorder;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
+use Zynga\PHPUnit\V2\TestSuite;
+use Zynga\PHPUnit\V2\TestSuite\OnTestClassChangeListener;
+use Zynga\PHPUnit\V2\TestSuite\Scheduler;
+use Zynga\PHPUnit\V2\TestSuite\StaticUtil;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
+use Zynga\PHPUnit\V2\IncompleteTestCase;
+use Zynga\PHPUnit\V2\SkippedTestCase;
+use Zynga\PHPUnit\V2\WarningTestCase;
+
+use \Exception;
+use \ReflectionClass;
+
+// --
+// Runs the tests of a suite across a pool of forked workers.
+//
+// The flattened plan is cut into groups of consecutive tests of the same
+// class, so before / after class hooks run once per group exactly like they
+// do serially. The Scheduler hands each worker a starting share, once that
+// is done a worker steals any group nobody has claimed yet. Workers run with
+// their listeners silenced and a Recorder attached, writing each group's
+// events out as it finishes.
+//
+// The parent replays those events onto its own TestResult strictly in plan
+// order as they become available, against its own copies of the tests, so
+// the printer and loggers see the same sequence a serial run would produce.
+// Deferred data providers stay deferred: the worker that claims the group
+// streams the data sets, the parent only creates a bare copy of each from
+// the events to report on.
+// After every group a worker also writes out the coverage it has collected
+// so far, so a worker that is killed or crashes only takes the coverage of
+// the group it was on with it. Those files are merged into the registered
+// files once every worker has exited.
+//
+// With time limits enforced, a worker still on the group the parent waits
+// for after every test in it could have used up its limit, plus some grace,
+// is killed. Its group is reported as timed out and a fresh worker takes
+// over stealing the groups left.
+// --
+class ParallelRunner {
+  const int POLL_INTERVAL_USEC = 10000;
+  const int TIME_LIMIT_GRACE = 10;
+
+  private int $_workers;
+
+  public function __construct(int $workers) {
+    $this->_workers = $workers;
+  }
+
+  public static function isSupported(): bool {
+    if (function_exists('pcntl_fork') && function_exists('pcntl_waitpid')) {
+      return true;
+    }
+    return false;
+  }
+
+  public function run(TestSuite $suite, TestResult $result): void {
+
+    $plan = $suite->getPlan();
+
+    $tests = $plan->getTests();
+    $groups = $plan->getClassGroups();
+
+    $positions = Map {};
+    $positions->set(spl_object_hash($suite), Recorder::SUITE_POSITION);
+    foreach ($tests as $position => $test) {
+      $positions->set(spl_object_hash($test), $position);
+    }
+
+    $codeCoverage = $result->getCodeCoverage();
+
+    // analyze the whitelist once here instead of once per worker.
+    if ($codeCoverage instanceof CodeCoverage) {
+      $codeCoverage->initialize();
+    }
+
+    $workDir = tempnam(sys_get_temp_dir(), 'hh-phpunit-workers-');
+    @unlink($workDir);
+    @mkdir($workDir, 0700);
+
+    $scheduler = new Scheduler($this->_workers, $result->getTimingDatabase());
+
+    list($shares, $stealOrder) = $scheduler->schedule($tests, $groups);
+
+    $running = Map {};
+    $reaped = Map {};
+
+    foreach ($shares as $share) {
+
+      $pid = pcntl_fork();
+
+      if ($pid == -1) {
+        // could not fork, the other workers steal this share.
+        continue;
+      }
+
+      if ($pid == 0) {
+        $this->runWorker(
+          $suite,
+          $result,
+          $tests,
+          $groups,
+          $share,
+          $stealOrder,
+          $positions,
+          $workDir,
+        );
+        exit(0);
+      }
+
+      $running->set($pid, true);
+
+    }
+
+    $next = 0;
+
+    while ($next < $groups->count()) {
+
+      $eventsFile = $this->getEventsFile($workDir, $next);
+
+      if (is_file($eventsFile)) {
+
+        $this->replay($suite, $result, $tests, $eventsFile);
+
+        @unlink($eventsFile);
+
+        $next++;
+
+        if ($result->shouldStop()) {
+          $this->stopWorkers($running);
+          break;
+        }
+
+        continue;
+
+      }
+
+      if ($running->count() > 0) {
+
+        $this->reapWorkers($running, $reaped);
+
+        $owner = $this->getClaimOwner($workDir, $next);
+
+        // the worker died on this group, which its events file may only
+        // have beaten the reaping to.
+        if ($reaped->containsKey($owner) && !is_file($eventsFile)) {
+
+          $this->reportLostGroup($result, $tests, $groups[$next], $owner);
+
+          $next++;
+
+          // its share is still there to steal, keep the pool at strength.
+          $this->forkStealer(
+            $suite,
+            $result,
+            $tests,
+            $groups,
+            $stealOrder,
+            $positions,
+            $workDir,
+            $running,
+          );
+
+          continue;
+
+        }
+
+        if ($result->enforcesTimeLimit() &&
+            $this->killStuckWorker(
+              $result,
+              $tests,
+              $groups[$next],
+              $running,
+              $owner,
+              $workDir.'/claim-'.$next,
+            )) {
+
+          $next++;
+
+          $this->forkStealer(
+            $suite,
+            $result,
+            $tests,
+            $groups,
+            $stealOrder,
+            $positions,
+            $workDir,
+            $running,
+          );
+
+          continue;
+
+        }
+
+        usleep(self::POLL_INTERVAL_USEC);
+        continue;
+
+      }
+
+      // every worker is gone, nobody is going to report on this group.
+      if (!is_file($eventsFile)) {
+        $this->reportLostGroup(
+          $result,
+          $tests,
+          $groups[$next],
+          $this->getClaimOwner($workDir, $next),
+        );
+        $next++;
+      }
+
+    }
+
+    foreach ($running->keys() as $pid) {
+      $status = 0;
+      pcntl_waitpid($pid, $status);
+    }
+
+    if ($codeCoverage instanceof CodeCoverage) {
+      foreach (glob($workDir.'/coverage-*') as $coverageFile) {
+        if (substr($coverageFile, -4) !== '.tmp') {
+          $this->mergeCoverage($coverageFile);
+        }
+      }
+    }
+
+    foreach (glob($workDir.'/*') as $leftOver) {
+      @unlink($leftOver);
+    }
+
+    @rmdir($workDir);
+
+  }
+
+  // --
+  // Replaces a worker that is gone. The replacement only steals, the share
+  // of the one it replaces is left to whoever claims it first.
+  // --
+  private function forkStealer(
+    TestSuite $suite,
+    TestResult $result,
+    ConstVector<TestInterface> $tests,
+    Vector<Vector<int>> $groups,
+    Vector<int> $stealOrder,
+    Map<string, int> $positions,
+    string $workDir,
+    Map<int, bool> $running,
+  ): void {
+
+    $pid = pcntl_fork();
+
+    if ($pid == 0) {
+      $this->runWorker(
+        $suite,
+        $result,
+        $tests,
+        $groups,
+        Vector {},
+        $stealOrder,
+        $positions,
+        $workDir,
+      );
+      exit(0);
+    }
+
+    if ($pid > 0) {
+      $running->set($pid, true);
+    }
+
+  }
+
+  private function runWorker(
+    TestSuite $suite,
+    TestResult $result,
+    ConstVector<TestInterface> $tests,
+    Vector<Vector<int>> $groups,
+    Vector<int> $share,
+    Vector<int> $stealOrder,
+    Map<string, int> $positions,
+    string $workDir,
+  ): void {
+
+    // anything the parent had buffered would otherwise be flushed twice.
+    while (ob_get_level() > 0) {
+      ob_end_clean();
+    }
+
+    // the parent prints, all the worker does is take notes.
+    $result->setListeners(new Listeners());
+
+    $recorder = new Recorder($positions);
+    $result->setRecorder($recorder);
+
+    $codeCoverage = $result->getCodeCoverage();
+    $coverageFile = null;
+
+    // its own share first, then whatever nobody has started on yet.
+    foreach (Vector {$share, $stealOrder} as $groupIds) {
+
+      foreach ($groupIds as $groupId) {
+
+        if ($this->claimGroup($workDir, $groupId) !== true) {
+          continue;
+        }
+
+        // a stop leaves the remaining groups with nothing to report, same as
+        // the tests a serial run never got to.
+        if (!$result->shouldStop()) {
+          $this->runGroup($result, $tests, $groups[$groupId]);
+        }
+
+        // coverage goes first, once the events are out the parent may
+        // already consider this worker done with the group.
+        if ($codeCoverage instanceof CodeCoverage) {
+          $coverageFile = $this->saveCoverage(
+            $codeCoverage,
+            $workDir,
+            $groupId,
+            $coverageFile,
+          );
+        }
+
+        $this->writeAtomic(
+          $this->getEventsFile($workDir, $groupId),
+          serialize($recorder->takeEvents()->toArray()),
+        );
+
+      }
+
+    }
+
+  }
+
+  // --
+  // Writes everything the worker has collected so far next to the events of
+  // the group, then drops the file of its previous group, which the new one
+  // covers. Merging is idempotent, so both being there after a crash in
+  // between does no harm.
+  // --
+  private function saveCoverage(
+    CodeCoverage $codeCoverage,
+    string $workDir,
+    int $groupId,
+    ?string $previousFile,
+  ): ?string {
+
+    $codeCoverage->flush();
+
+    $coverageFile = $workDir.'/coverage-'.getmypid().'-'.$groupId;
+
+    $payload = serialize($this->exportCoverage());
+
+    if ($this->writeAtomic($coverageFile, $payload) !== true) {
+      return $previousFile;
+    }
+
+    if ($previousFile !== null) {
+      @unlink($previousFile);
+    }
+
+    return $coverageFile;
+
+  }
+
+  // --
+  // The serial TestSuite::run() loop for a single class worth of tests.
+  // --
+  private function runGroup(
+    TestResult $result,
+    ConstVector<TestInterface> $tests,
+    Vector<int> $group,
+  ): void {
+
+    OnTestClassChangeListener::clear();
+
+    $isFirst = true;
+
+    foreach ($group as $position) {
+
+      $test = $tests[$position];
+
+      if ($isFirst === true) {
+
+        list($beforeOk, $beforeException) =
+          OnTestClassChangeListener::handleBeforeClass($test);
+
+        if ($beforeOk !== true && $beforeException instanceof Exception) {
+          // the whole class goes down, each of its tests reported on its own
+          // so the counts match the plan.
+          foreach ($group as $failedPosition) {
+            $failedTest = $tests[$failedPosition];
+            $result->startTest($failedTest);
+            $result->addError($failedTest, $beforeException, 0.0);
+            $result->endTest($failedTest, 0.0);
+          }
+          OnTestClassChangeListener::clear();
+          return;
+        }
+
+      }
+
+      if ($result->shouldStop()) {
+        break;
+      }
+
+      $test->run($result);
+
+      if ($isFirst === true) {
+        OnTestClassChangeListener::setClass($test);
+        $isFirst = false;
+      }
+
+    }
+
+    OnTestClassChangeListener::handleAfterClass();
+    OnTestClassChangeListener::clear();
+
+  }
+
+  private function replay(
+    TestSuite $suite,
+    TestResult $result,
+    ConstVector<TestInterface> $tests,
+    string $eventsFile,
+  ): void {
+
+    $payload = file_get_contents($eventsFile);
+
+    if (!is_string($payload) || $payload == '') {
+      return;
+    }
+
+    $events = unserialize($payload);
+
+    if (!is_array($events)) {
+      return;
+    }
+
+    // the parent's own copies of the data sets the worker ran, by ordinal.
+    $dataSets = Map {};
+    // stand-in position => data sets it ran
+    $dataSetCounts = Map {};
+
+    foreach ($events as $event) {
+
+      if (!is_array($event) ||
+          count($event) != 4 ||
+          $event[0] !== Recorder::EVENT_DATA_SET ||
+          !is_array($event[3]) ||
+          count($event[3]) != 3) {
+        continue;
+      }
+
+      $position = intval($event[1]);
+
+      $dataSet = $this->createDataSetTest(
+        $tests->get($position),
+        strval($event[3][0]),
+        strval($event[3][1]),
+        strval($event[3][2]),
+      );
+
+      if ($dataSet instanceof TestInterface) {
+        $dataSets->set(intval($event[2]), $dataSet);
+        $dataSetCounts->set($position, intval($dataSetCounts->get($position)) + 1);
+      }
+
+    }
+
+    // loggers read the profile off the test as soon as a defect comes in,
+    // ahead of the endTest event carrying it.
+    foreach ($events as $event) {
+      if (is_array($event) &&
+          count($event) == 4 &&
+          $event[0] === Recorder::EVENT_END_TEST &&
+          is_array($event[3]) &&
+          count($event[3]) == 8 &&
+          is_array($event[3][7])) {
+        $test = $this->getReplayedTest(
+          $suite,
+          $tests,
+          $dataSets,
+          intval($event[1]),
+          intval($event[2]),
+        );
+        if ($test instanceof TestCase) {
+          $test->setProfile(TestProfile::fromArray($event[3][7]));
+        }
+      }
+    }
+
+    foreach ($events as $event) {
+
+      if (!is_array($event) || count($event) != 4) {
+        continue;
+      }
+
+      list($type, $position, $ordinal, $data) = $event;
+
+      $test = $this->getReplayedTest(
+        $suite,
+        $tests,
+        $dataSets,
+        intval($position),
+        intval($ordinal),
+      );
+
+      if (!$test instanceof TestInterface || !is_array($data)) {
+        continue;
+      }
+
+      switch ($type) {
+        case Recorder::EVENT_START_TEST:
+          // a stand-in whose provider gave nothing runs as a plain test.
+          if ($test instanceof TestCase && $test->isLazyDataProvider()) {
+            $test->setLazyDataProvider(false);
+          }
+          $result->startTest($test);
+          break;
+        case Recorder::EVENT_ADD_ERROR:
+          $result->addError(
+            $test,
+            Recorder::unpackException($data[0]),
+            floatval($data[1]),
+          );
+          break;
+        case Recorder::EVENT_ADD_FAILURE:
+          $result->addFailure(
+            $test,
+            Recorder::unpackException($data[0]),
+            floatval($data[1]),
+          );
+          break;
+        case Recorder::EVENT_ADD_WARNING:
+          $result->addWarning(
+            $test,
+            Recorder::unpackException($data[0]),
+            floatval($data[1]),
+          );
+          break;
+        case Recorder::EVENT_END_TEST:
+          if ($test instanceof TestCase && count($data) >= 7) {
+            $test->status()
+              ->setMessageAndCode(strval($data[2]), intval($data[1]));
+            $test->addToAssertionCount(
+              intval($data[3]) - $test->getNumAssertions(),
+            );
+            $test->restoreOutput(
+              strval($data[4]),
+              strval($data[5]),
+              intval($data[6]),
+            );
+          }
+          $result->endTest($test, floatval($data[0]));
+          break;
+      }
+
+    }
+
+    $timings = $result->getTimingDatabase();
+
+    foreach ($dataSetCounts as $position => $count) {
+
+      $standIn = $tests->get($position);
+
+      if (!$standIn instanceof TestCase) {
+        continue;
+      }
+
+      $standIn->setProvidedTestCount($count);
+
+      if ($timings instanceof TimingDatabase && !$result->shouldStop()) {
+        $timings->recordDataSetCount(
+          $standIn->getClass(),
+          $standIn->getName(),
+          $count,
+        );
+      }
+
+    }
+
+  }
+
+  private function getReplayedTest(
+    TestSuite $suite,
+    ConstVector<TestInterface> $tests,
+    Map<int, TestInterface> $dataSets,
+    int $position,
+    int $ordinal,
+  ): ?TestInterface {
+
+    if ($position == Recorder::SUITE_POSITION) {
+      return $suite;
+    }
+
+    if ($ordinal != Recorder::NO_ORDINAL) {
+      return $dataSets->get($ordinal);
+    }
+
+    return $tests->get($position);
+
+  }
+
+  // --
+  // A copy of a data set test the worker created, enough for the printer
+  // and loggers to report on. The data itself stays with the worker, the
+  // parent never runs it.
+  // --
+  private function createDataSetTest(
+    ?TestInterface $standIn,
+    string $className,
+    string $name,
+    string $dataName,
+  ): ?TestInterface {
+
+    if (!$standIn instanceof TestCase) {
+      return null;
+    }
+
+    $test = null;
+
+    if ($className === IncompleteTestCase::class) {
+      $test = new IncompleteTestCase('', '');
+    } else if ($className === SkippedTestCase::class) {
+      $test = new SkippedTestCase('', '');
+    } else if ($className === WarningTestCase::class) {
+      $test = new WarningTestCase();
+    } else if ($className === $standIn->getClass()) {
+      $theClass = ReflectionClasses::getReflection($className);
+      if ($theClass instanceof ReflectionClass) {
+        $test = StaticUtil::createTest_Simple(
+          $theClass,
+          $name,
+          Vector {$name, null, $dataName},
+        );
+      }
+    }
+
+    if (!$test instanceof TestCase) {
+      return null;
+    }
+
+    $test->setName($name);
+    $test->setDependencies($standIn->getDependencies());
+    $test->setGroups($standIn->getGroups());
+
+    return $test;
+
+  }
+
+  private function reportLostGroup(
+    TestResult $result,
+    ConstVector<TestInterface> $tests,
+    Vector<int> $group,
+    int $pid,
+  ): void {
+
+    $e = new WorkerFailedException(
+      'worker pid='.$pid.' exited before reporting on this test',
+    );
+
+    foreach ($group as $position) {
+      $test = $tests[$position];
+      $result->startTest($test);
+      $result->addError($test, $e, 0.0);
+      $result->endTest($test, 0.0);
+    }
+
+  }
+
+  // --
+  // Kills the worker that has been on the group for longer than all of its
+  // tests are allowed to take and reports them as timed out.
+  // --
+  private function killStuckWorker(
+    TestResult $result,
+    ConstVector<TestInterface> $tests,
+    Vector<int> $group,
+    Map<int, bool> $running,
+    int $pid,
+    string $claimFile,
+  ): bool {
+
+    if (!function_exists('posix_kill') ||
+        $running->containsKey($pid) !== true ||
+        !is_file($claimFile)) {
+      return false;
+    }
+
+    $timeLimit = self::TIME_LIMIT_GRACE;
+
+    foreach ($group as $position) {
+      $test = $tests[$position];
+      if ($test instanceof TestCase) {
+        // a stand-in runs every data set of its provider.
+        $timeLimit += $result->getTimeoutForTest($test) * $test->count();
+      }
+    }
+
+    if (time() - intval(filemtime($claimFile)) <= $timeLimit) {
+      return false;
+    }
+
+    posix_kill($pid, SIGKILL);
+
+    $status = 0;
+    pcntl_waitpid($pid, $status);
+
+    $running->remove($pid);
+
+    $e = new TimeoutException(
+      'worker pid='.
+      $pid.
+      ' killed after '.
+      $timeLimit.
+      ' seconds on this test class',
+    );
+
+    foreach ($group as $position) {
+      $test = $tests[$position];
+      $result->startTest($test);
+      $result->addFailure($test, $e, 0.0);
+      $result->endTest($test, 0.0);
+    }
+
+    return true;
+
+  }
+
+  private function reapWorkers(
+    Map<int, bool> $running,
+    Map<int, bool> $reaped,
+  ): void {
+    foreach ($running->keys() as $pid) {
+      $status = 0;
+      if (pcntl_waitpid($pid, $status, WNOHANG) != 0) {
+        $running->remove($pid);
+        $reaped->set($pid, true);
+      }
+    }
+  }
+
+  private function stopWorkers(Map<int, bool> $running): void {
+    if (!function_exists('posix_kill')) {
+      return;
+    }
+    foreach ($running->keys() as $pid) {
+      posix_kill($pid, SIGTERM);
+    }
+  }
+
+  // --
+  // Line states and line to test attribution of every file a test touched,
+  // as plain arrays.
+  // --
+  private function exportCoverage(): array<string, array<mixed>> {
+
+    $coverage = array();
+
+    foreach (FileFactory::getFileNames() as $fileName) {
+
+      $file = FileFactory::get($fileName);
+
+      $lineToTests = $file->lineToTestToArrayFormat();
+
+      if (count($lineToTests) == 0) {
+        continue;
+      }
+
+      $coverage[$fileName] = array(
+        $file->lineExecutionState()->getAll()->toArray(),
+        $lineToTests,
+      );
+
+    }
+
+    return $coverage;
+
+  }
+
+  private function mergeCoverage(string $coverageFile): void {
+
+    $payload = file_get_contents($coverageFile);
+
+    if (!is_string($payload) || $payload == '') {
+      return;
+    }
+
+    $coverage = unserialize($payload);
+
+    if (!is_array($coverage)) {
+      return;
+    }
+
+    foreach ($coverage as $fileName => $fileData) {
+
+      if (!is_array($fileData) || count($fileData) != 2) {
+        continue;
+      }
+
+      list($lineStates, $lineToTests) = $fileData;
+
+      if (FileFactory::isFileRegistered(strval($fileName)) === false) {
+        continue;
+      }
+
+      $file = FileFactory::get(strval($fileName));
+
+      $lineExecutionState = $file->lineExecutionState();
+
+      $executedLines = Vector {};
+
+      if (is_array($lineStates)) {
+        foreach ($lineStates as $lineNo => $lineState) {
+          if ($lineState === Driver::LINE_EXECUTED) {
+            $executedLines->add(intval($lineNo));
+          } else {
+            $lineExecutionState->set(intval($lineNo), intval($lineState));
+          }
+        }
+      }
+
+      $lineExecutionState->markExecutedLines($executedLines);
+
+      if (is_array($lineToTests)) {
+        foreach ($lineToTests as $lineNo => $testIds) {
+          if (!is_array($testIds)) {
+            continue;
+          }
+          foreach ($testIds as $testId) {
+            $file->setLineToTest(intval($lineNo), strval($testId));
+          }
+        }
+      }
+
+    }
+
+  }
+
+  private function getEventsFile(string $workDir, int $groupId): string {
+    return $workDir.'/group-'.$groupId;
+  }
+
+  // --
+  // Exclusive create of the claim file decides which worker runs a group,
+  // the file holds the pid of the winner.
+  // --
+  private function claimGroup(string $workDir, int $groupId): bool {
+
+    $handle = @fopen($workDir.'/claim-'.$groupId, 'x');
+
+    if ($handle === false) {
+      return false;
+    }
+
+    fwrite($handle, strval(getmypid()));
+    fclose($handle);
+
+    return true;
+
+  }
+
+  private function getClaimOwner(string $workDir, int $groupId): int {
+    $claimFile = $workDir.'/claim-'.$groupId;
+    if (!is_file($claimFile)) {
+      return -1;
+    }
+    return intval(file_get_contents($claimFile));
+  }
+
+  private function writeAtomic(string $fileName, string $payload): bool {
+    $tmpFile = $fileName.'.tmp';
+    if (file_put_contents($tmpFile, $payload) === false) {
+      return false;
+    }
+    return rename($tmpFile, $fileName);
+  }
+
+}
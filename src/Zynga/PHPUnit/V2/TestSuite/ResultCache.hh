@@ -0,0 +1,220 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestSuite;
+
+use Zynga\Framework\ReflectionCache\V1\ReflectionClasses;
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestResult;
+
+use \ReflectionClass;
+
+// --
+// The outcome of every test from previous runs, keyed by test id
+// (<class>::<method>), and the mtime each test class's file had when it last
+// ran.
+//
+// recordResult() takes the defects and passes of a finished run and writes them
+// over the recorded ones, tests that did not run keep their last outcome.
+// TestOrder reads it back to put defects and edited test classes first.
+// --
+class ResultCache {
+  const string FORMAT_VERSION = '1';
+
+  const string OUTCOME_DEFECT = 'defect';
+  const string OUTCOME_PASSED = 'passed';
+
+  private string $_cacheFile;
+
+  // test id => outcome
+  private Map<string, string> $_outcomes;
+
+  // class => mtime of the file declaring it
+  private Map<string, int> $_classTimes;
+
+  public function __construct(string $cacheFile) {
+    $this->_cacheFile = $cacheFile;
+    $this->_outcomes = Map {};
+    $this->_classTimes = Map {};
+  }
+
+  public function getCacheFile(): string {
+    return $this->_cacheFile;
+  }
+
+  public static function getTestId(
+    string $className,
+    string $methodName,
+  ): string {
+    return $className.'::'.$methodName;
+  }
+
+  public function load(): bool {
+
+    if (!is_file($this->_cacheFile)) {
+      return false;
+    }
+
+    $payload = file_get_contents($this->_cacheFile);
+
+    if (!is_string($payload) || $payload == '') {
+      return false;
+    }
+
+    $data = unserialize($payload);
+
+    if (!is_array($data) ||
+        !array_key_exists('version', $data) ||
+        $data['version'] !== self::FORMAT_VERSION ||
+        !array_key_exists('outcomes', $data) ||
+        !is_array($data['outcomes']) ||
+        !array_key_exists('classes', $data) ||
+        !is_array($data['classes'])) {
+      return false;
+    }
+
+    foreach ($data['outcomes'] as $testId => $outcome) {
+      $this->_outcomes->set(strval($testId), strval($outcome));
+    }
+
+    foreach ($data['classes'] as $className => $mtime) {
+      $this->_classTimes->set(strval($className), intval($mtime));
+    }
+
+    return true;
+
+  }
+
+  public function record(
+    string $className,
+    string $methodName,
+    string $outcome,
+  ): void {
+    $this->_outcomes->set(self::getTestId($className, $methodName), $outcome);
+  }
+
+  public function recordResult(TestResult $result): void {
+
+    $classes = Set {};
+
+    foreach ($result->passed()->keys() as $testId) {
+
+      $separator = strpos($testId, '::');
+
+      if ($separator === false) {
+        continue;
+      }
+
+      $className = substr($testId, 0, $separator);
+
+      $this->record(
+        $className,
+        substr($testId, $separator + 2),
+        self::OUTCOME_PASSED,
+      );
+
+      $classes->add($className);
+
+    }
+
+    $defects = Vector {};
+    $defects->addAll($result->errors());
+    $defects->addAll($result->failures());
+
+    foreach ($defects as $defect) {
+
+      $test = $defect->failedTest();
+
+      if (!$test instanceof TestCase) {
+        continue;
+      }
+
+      $this->record(
+        $test->getClass(),
+        $test->getName(),
+        self::OUTCOME_DEFECT,
+      );
+
+      $classes->add($test->getClass());
+
+    }
+
+    foreach ($classes as $className) {
+      $this->_classTimes->set($className, self::getClassFileTime($className));
+    }
+
+  }
+
+  public function getOutcome(string $className, string $methodName): ?string {
+    return $this->_outcomes->get(self::getTestId($className, $methodName));
+  }
+
+  public function isDefect(string $className, string $methodName): bool {
+    if ($this->getOutcome($className, $methodName) === self::OUTCOME_DEFECT) {
+      return true;
+    }
+    return false;
+  }
+
+  // --
+  // Whether the class's file was edited since the class last ran, classes
+  // that never ran count as changed.
+  // --
+  public function isClassChanged(string $className): bool {
+
+    $mtime = $this->_classTimes->get($className);
+
+    if ($mtime === null) {
+      return true;
+    }
+
+    if ($mtime != self::getClassFileTime($className)) {
+      return true;
+    }
+
+    return false;
+
+  }
+
+  public static function getClassFileTime(string $className): int {
+
+    $reflection = ReflectionClasses::getReflection($className);
+
+    if (!$reflection instanceof ReflectionClass) {
+      return 0;
+    }
+
+    $fileName = $reflection->getFileName();
+
+    if (!is_string($fileName) || !is_file($fileName)) {
+      return 0;
+    }
+
+    return intval(filemtime($fileName));
+
+  }
+
+  public function save(): bool {
+
+    $data = array(
+      'version' => self::FORMAT_VERSION,
+      'outcomes' => $this->_outcomes->toArray(),
+      'classes' => $this->_classTimes->toArray(),
+    );
+
+    $cacheDir = dirname($this->_cacheFile);
+
+    if (!is_dir($cacheDir)) {
+      @mkdir($cacheDir, 0755, true);
+    }
+
+    $tmpFile = $this->_cacheFile.'.'.getmypid().'.tmp';
+
+    if (file_put_contents($tmpFile, serialize($data)) === false) {
+      return false;
+    }
+
+    return rename($tmpFile, $this->_cacheFile);
+
+  }
+
+}
@@ -0,0 +1,146 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestSuite;
+
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
+
+// --
+// Decides which worker runs which group of tests.
+//
+// Groups whose class has recorded timings are assigned up front, longest
+// processing time first: the slowest group goes to the least loaded worker.
+// Groups without history are left unassigned and picked up by whichever
+// worker runs out of work first, as is anything a busy worker has not got to
+// yet. The steal order lists every group slowest first, so the expensive
+// leftovers get started early.
+// --
+class Scheduler {
+  private int $_workers;
+  private ?TimingDatabase $_timings;
+
+  public function __construct(int $workers, ?TimingDatabase $timings) {
+    $this->_workers = $workers;
+    $this->_timings = $timings;
+  }
+
+  public function getWorkerCount(Vector<Vector<int>> $groups): int {
+    return max(1, min($this->_workers, $groups->count()));
+  }
+
+  // --
+  // Expected seconds for the group, null when its class was never timed.
+  // Methods added since the last run are assumed to take the mean time.
+  // --
+  public function estimate(
+    ConstVector<TestInterface> $tests,
+    Vector<int> $group,
+  ): ?float {
+
+    $timings = $this->_timings;
+
+    if (!$timings instanceof TimingDatabase || $group->count() == 0) {
+      return null;
+    }
+
+    $className = get_class($tests[$group[0]]);
+
+    if ($timings->hasClass($className) !== true) {
+      return null;
+    }
+
+    $meanTime = $timings->getMeanMethodTime();
+
+    $total = 0.0;
+
+    foreach ($group as $position) {
+      $test = $tests[$position];
+      $time = null;
+      if ($test instanceof TestCase) {
+        $time = $timings->getMethodTime($className, $test->getName());
+      }
+      if ($time === null) {
+        $time = $meanTime;
+      }
+      // a deferred data provider stands in for all of its data sets.
+      $total += $time * $test->count();
+    }
+
+    return $total;
+
+  }
+
+  // --
+  // The groups each worker starts out with, in plan order, and the order
+  // idle workers steal in.
+  // --
+  public function schedule(
+    ConstVector<TestInterface> $tests,
+    Vector<Vector<int>> $groups,
+  ): (Vector<Vector<int>>, Vector<int>) {
+
+    $workerCount = $this->getWorkerCount($groups);
+
+    $meanTime = 0.0;
+    if ($this->_timings instanceof TimingDatabase) {
+      $meanTime = $this->_timings->getMeanMethodTime();
+    }
+
+    $known = array();
+    $all = array();
+
+    foreach ($groups as $groupId => $group) {
+      $estimate = $this->estimate($tests, $group);
+      if ($estimate === null) {
+        $all[$groupId] = $meanTime * $group->count();
+      } else {
+        $known[$groupId] = $estimate;
+        $all[$groupId] = $estimate;
+      }
+    }
+
+    $shares = Vector {};
+    $loads = Vector {};
+    for ($i = 0; $i < $workerCount; $i++) {
+      $shares->add(Vector {});
+      $loads->add(0.0);
+    }
+
+    arsort($known);
+
+    foreach ($known as $groupId => $estimate) {
+      $target = 0;
+      for ($i = 1; $i < $workerCount; $i++) {
+        if ($loads[$i] < $loads[$target]) {
+          $target = $i;
+        }
+      }
+      $shares[$target]->add($groupId);
+      $loads[$target] = $loads[$target] + $estimate;
+    }
+
+    foreach ($shares as $offset => $share) {
+      $ordered = $share->toArray();
+      sort($ordered);
+      $shares[$offset] = new Vector($ordered);
+    }
+
+    // slowest first, plan order between equals so a suite without any
+    // history is simply worked through front to back.
+    $groupIds = array_keys($all);
+    usort(
+      $groupIds,
+      function(int $a, int $b): int use ($all) {
+        if ($all[$a] != $all[$b]) {
+          return $all[$a] < $all[$b] ? 1 : -1;
+        }
+        return $a - $b;
+      },
+    );
+
+    return tuple($shares, new Vector($groupIds));
+
+  }
+
+}
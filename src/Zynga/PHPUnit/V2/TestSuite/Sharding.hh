@@ -0,0 +1,338 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestSuite;
+
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestSuite\Scheduler;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
+
+// --
+// Splits a test plan by class into a fixed number of shards, so separate
+// machines can each run one of them.
+//
+// The split only depends on the plan and the timing database handed in.
+// Classes are placed longest first onto the least loaded shard, ties going
+// by class name and then shard number. Without any timings a class weighs as
+// much as it has tests.
+//
+// Timing databases are local to each machine, so machines left to partition
+// on their own may not agree. The manifest one of them writes is meant to be
+// handed to the rest: partitionFromManifest() follows it as it is, whatever
+// the local timings say.
+// --
+class Sharding {
+  const string MANIFEST_VERSION = '1';
+
+  private int $_shardCount;
+  private ?TimingDatabase $_timings;
+
+  public function __construct(int $shardCount, ?TimingDatabase $timings) {
+    $this->_shardCount = max(1, $shardCount);
+    $this->_timings = $timings;
+  }
+
+  // --
+  // Parses "k/n" into (k, n), k counting from 1.
+  // --
+  public static function parseShard(string $shard): ?(int, int) {
+
+    $matches = array();
+
+    if (preg_match('/^\s*(\d+)\s*\/\s*(\d+)\s*$/', $shard, $matches) !== 1) {
+      return null;
+    }
+
+    $shardIndex = intval($matches[1]);
+    $shardCount = intval($matches[2]);
+
+    if ($shardCount < 1 || $shardIndex < 1 || $shardIndex > $shardCount) {
+      return null;
+    }
+
+    return tuple($shardIndex, $shardCount);
+
+  }
+
+  // --
+  // The classes of each shard, shard k at offset k - 1, each in plan order.
+  // --
+  public function partition(
+    ConstVector<TestInterface> $tests,
+  ): Vector<Vector<string>> {
+
+    $weights = $this->getClassWeights($tests);
+
+    $classNames = $weights->keys()->toArray();
+
+    usort(
+      $classNames,
+      function(string $a, string $b): int use ($weights) {
+        if ($weights[$a] != $weights[$b]) {
+          return $weights[$a] < $weights[$b] ? 1 : -1;
+        }
+        return strcmp($a, $b);
+      },
+    );
+
+    $loads = Vector {};
+    $assignments = Map {};
+
+    for ($i = 0; $i < $this->_shardCount; $i++) {
+      $loads->add(0.0);
+    }
+
+    foreach ($classNames as $className) {
+      $target = 0;
+      for ($i = 1; $i < $this->_shardCount; $i++) {
+        if ($loads[$i] < $loads[$target]) {
+          $target = $i;
+        }
+      }
+      $assignments->set($className, $target);
+      $loads[$target] = $loads[$target] + $weights[$className];
+    }
+
+    $shards = Vector {};
+    for ($i = 0; $i < $this->_shardCount; $i++) {
+      $shards->add(Vector {});
+    }
+
+    // weights keeps the plan order of the classes.
+    foreach ($weights->keys() as $className) {
+      $shards[$assignments[$className]]->add($className);
+    }
+
+    return $shards;
+
+  }
+
+  // --
+  // Follows the split of a manifest. Classes it does not list, added since it
+  // was written, go to a shard picked by a hash of their name so every
+  // machine places them alike.
+  // --
+  public function partitionFromManifest(
+    ConstVector<TestInterface> $tests,
+    Vector<Vector<string>> $manifestShards,
+  ): Vector<Vector<string>> {
+
+    $assignments = Map {};
+
+    foreach ($manifestShards as $offset => $classNames) {
+      foreach ($classNames as $className) {
+        // a class listed twice stays on the first shard listing it.
+        if (!$assignments->containsKey($className)) {
+          $assignments->set($className, $offset);
+        }
+      }
+    }
+
+    $shards = Vector {};
+    for ($i = 0; $i < $this->_shardCount; $i++) {
+      $shards->add(Vector {});
+    }
+
+    $seen = Map {};
+
+    foreach ($tests as $test) {
+
+      $className = get_class($test);
+
+      if ($seen->containsKey($className)) {
+        continue;
+      }
+
+      $seen->set($className, true);
+
+      $target = $assignments->get($className);
+
+      if ($target === null || $target >= $this->_shardCount) {
+        $target = crc32($className) % $this->_shardCount;
+      }
+
+      $shards[$target]->add($className);
+
+    }
+
+    return $shards;
+
+  }
+
+  // --
+  // The classes of each shard as a manifest lists them, null when it cannot
+  // be read or was written for another number of shards.
+  // --
+  public function readManifest(string $manifestFile): ?Vector<Vector<string>> {
+
+    if (!is_file($manifestFile)) {
+      return null;
+    }
+
+    $payload = file_get_contents($manifestFile);
+
+    if (!is_string($payload)) {
+      return null;
+    }
+
+    $manifest = json_decode($payload, true);
+
+    if (!is_array($manifest) ||
+        !array_key_exists('version', $manifest) ||
+        $manifest['version'] !== self::MANIFEST_VERSION ||
+        !array_key_exists('shardCount', $manifest) ||
+        $manifest['shardCount'] !== $this->_shardCount ||
+        !array_key_exists('shards', $manifest) ||
+        !is_array($manifest['shards'])) {
+      return null;
+    }
+
+    $shards = Vector {};
+    for ($i = 0; $i < $this->_shardCount; $i++) {
+      $shards->add(Vector {});
+    }
+
+    foreach ($manifest['shards'] as $manifestShard) {
+
+      if (!is_array($manifestShard) ||
+          !array_key_exists('shard', $manifestShard) ||
+          !array_key_exists('classes', $manifestShard) ||
+          !is_array($manifestShard['classes'])) {
+        return null;
+      }
+
+      $offset = intval($manifestShard['shard']) - 1;
+
+      if ($offset < 0 || $offset >= $this->_shardCount) {
+        return null;
+      }
+
+      foreach ($manifestShard['classes'] as $className) {
+        if (is_string($className)) {
+          $shards[$offset]->add($className);
+        }
+      }
+
+    }
+
+    return $shards;
+
+  }
+
+  public function writeManifest(
+    string $manifestFile,
+    ConstVector<TestInterface> $tests,
+    Vector<Vector<string>> $shards,
+  ): bool {
+
+    $weights = $this->getClassWeights($tests);
+
+    $testCounts = Map {};
+    foreach ($tests as $test) {
+      $className = get_class($test);
+      $testCounts->set($className, intval($testCounts->get($className)) + 1);
+    }
+
+    $manifestShards = array();
+
+    foreach ($shards as $offset => $classNames) {
+      $estimate = 0.0;
+      $testCount = 0;
+      foreach ($classNames as $className) {
+        $estimate += $weights[$className];
+        $testCount += $testCounts[$className];
+      }
+      $manifestShards[] = array(
+        'shard' => $offset + 1,
+        'estimate' => $estimate,
+        'tests' => $testCount,
+        'classes' => $classNames->toArray(),
+      );
+    }
+
+    $manifest = array(
+      'version' => self::MANIFEST_VERSION,
+      'shardCount' => $this->_shardCount,
+      'timed' => $this->hasTimings(),
+      'shards' => $manifestShards,
+    );
+
+    $manifestDir = dirname($manifestFile);
+
+    if (!is_dir($manifestDir)) {
+      @mkdir($manifestDir, 0755, true);
+    }
+
+    $payload = json_encode($manifest, JSON_PRETTY_PRINT);
+
+    if (!is_string($payload)) {
+      return false;
+    }
+
+    return file_put_contents($manifestFile, $payload."\n") !== false;
+
+  }
+
+  // --
+  // Estimated seconds per class, or tests per class without timings, in
+  // plan order.
+  // --
+  private function getClassWeights(
+    ConstVector<TestInterface> $tests,
+  ): Map<string, float> {
+
+    $classPositions = Map {};
+
+    foreach ($tests as $position => $test) {
+      $className = get_class($test);
+      $positions = $classPositions->get($className);
+      if ($positions === null) {
+        $positions = Vector {};
+        $classPositions->set($className, $positions);
+      }
+      $positions->add($position);
+    }
+
+    $weights = Map {};
+
+    $isTimed = $this->hasTimings();
+    $scheduler = new Scheduler($this->_shardCount, $this->_timings);
+    $meanTime = 0.0;
+
+    if ($this->_timings instanceof TimingDatabase) {
+      $meanTime = $this->_timings->getMeanMethodTime();
+    }
+
+    foreach ($classPositions as $className => $positions) {
+
+      if ($isTimed !== true) {
+        $testCount = 0;
+        foreach ($positions as $position) {
+          $testCount += $tests[$position]->count();
+        }
+        $weights->set($className, floatval($testCount));
+        continue;
+      }
+
+      $estimate = $scheduler->estimate($tests, $positions);
+
+      if ($estimate === null) {
+        $estimate = $meanTime * $positions->count();
+      }
+
+      $weights->set($className, $estimate);
+
+    }
+
+    return $weights;
+
+  }
+
+  private function hasTimings(): bool {
+    if ($this->_timings instanceof TimingDatabase &&
+        $this->_timings->getMeanMethodTime() > 0.0) {
+      return true;
+    }
+    return false;
+  }
+
+}
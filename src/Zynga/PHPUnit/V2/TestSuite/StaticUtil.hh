@@ -12,6 +12,7 @@ use Zynga\PHPUnit\V2\Annotations;
 use Zynga\PHPUnit\V2\IncompleteTestCase;
 use Zynga\PHPUnit\V2\Interfaces\TestInterface;
 use Zynga\PHPUnit\V2\SkippedTestCase;
+use Zynga\PHPUnit\V2\TestCase;
 use Zynga\PHPUnit\V2\TestSuite\DataProvider;
 use Zynga\PHPUnit\V2\TestSuite\DataProvider\Loader;
 use Zynga\PHPUnit\V2\WarningTestCase;
@@ -21,6 +22,7 @@ use \Exception;
 use \ReflectionClass;
 use \ReflectionMethod;
 use \ReflectionType;
+use \Iterator;
 
 class StaticUtil {
 
@@ -209,22 +211,23 @@ class StaticUtil {
 
       if ($paramCount < 2) {
         $test = self::createTest_Simple($theClass, $name, Vector {$name});
-      } else {
+      } else if (Loader::getProviderFunctionName($className, $name) !==
+                 null) {
 
         // Support for dataprovider based loading.
         // TestCase($name, $data)
-        $data = self::createTest_LoadData($theClass, $name);
-
-        // Test method with @dataProvider.
-        if ($data != null) {
-
-          $test = self::createViaProvidedData($theClass, $name, $data);
+        //
+        // The provider is not called until the test is about to run, until
+        // then the test stands in for all of its data sets, see LazyRunner.
+        $test = self::createTest_Simple($theClass, $name, Vector {$name});
 
-        } else {
+        if ($test instanceof TestCase) {
+          $test->setLazyDataProvider(true);
+        }
 
-          $test = self::createTest_Simple($theClass, $name, Vector {$name});
+      } else {
 
-        }
+        $test = self::createTest_Simple($theClass, $name, Vector {$name});
 
       }
 
@@ -240,7 +243,31 @@ class StaticUtil {
 
   }
 
-  private static function createViaProvidedData(
+  /**
+   * Calls the data provider of a test and builds a test for every data set
+   * it provides, what a lazy data provider test expands to.
+   *
+   * @param ReflectionClass $theClass
+   * @param string          $name
+   *
+   * @return TestInterface
+   */
+  final public static function createTest_Provided(
+    ReflectionClass $theClass,
+    string $name,
+  ): TestInterface {
+
+    $data = self::createTest_LoadData($theClass, $name);
+
+    if ($data != null) {
+      return self::createViaProvidedData($theClass, $name, $data);
+    }
+
+    return self::createTest_Simple($theClass, $name, Vector {$name});
+
+  }
+
+  final public static function createViaProvidedData(
     ReflectionClass $theClass,
     string $name,
     mixed $data,
@@ -260,6 +287,18 @@ class StaticUtil {
       );
     }
 
+    // Handle the use case of a generator or iterator yielding the data sets
+    if ($data instanceof Iterator) {
+      $groups = $test->getGroupsFromAnnotation();
+      foreach ($data as $_dataName => $_data) {
+        $test->addTest(
+          self::createDataSetTest($theClass, $name, strval($_dataName), $_data),
+          $groups,
+        );
+      }
+      return $test;
+    }
+
     // Handle the use case of a object based param
     if (is_object($data)) {
       return self::addToDataProvidedTest_ObjectParam(
@@ -427,42 +466,62 @@ class StaticUtil {
 
       foreach ($data as $_dataName => $_data) {
 
-        list($argOk, $argError) = self::verifyTestArgumentsFitShapeRequested(
+        // JEO: At times $_dataName can be a int somehow? Let's coerce it to string.
+        $_test = self::createDataSetTest(
           $theClass,
           $name,
+          strval($_dataName),
           $_data,
         );
 
-        if ($argOk === true) {
-
-          // JEO: At times $_dataName can be a int somehow? Let's coerce it to string.
-          $args = Vector {$name, $_data, strval($_dataName)};
-          $_test = self::createTest_Simple($theClass, $name, $args);
-          $test->addTest($_test, $groups);
+        $test->addTest($_test, $groups);
 
-        } else {
+      }
+    }
 
-          $incompleteTest =
-            new IncompleteTestCase(
-              $className,
-              $name,
-              sprintf(
-                'Data was invalid for test  className=%s method=%s data=%s argError=%s',
-                $className,
-                $name,
-                json_encode($_data),
-                $argError,
-              ),
-            );
+    return $test;
+  }
 
-          $test->addTest($incompleteTest, $groups);
+  /**
+   * Builds the test for a single data set, an incomplete test when the data
+   * does not fit the arguments of the test method.
+   *
+   * @param ReflectionClass $theClass
+   * @param string          $name
+   * @param string          $dataName
+   * @param mixed           $data
+   *
+   * @return TestInterface
+   */
+  final public static function createDataSetTest(
+    ReflectionClass $theClass,
+    string $name,
+    string $dataName,
+    mixed $data,
+  ): TestInterface {
 
-        }
+    list($argOk, $argError) =
+      self::verifyTestArgumentsFitShapeRequested($theClass, $name, $data);
 
-      }
+    if ($argOk === true) {
+      $args = Vector {$name, $data, $dataName};
+      return self::createTest_Simple($theClass, $name, $args);
     }
 
-    return $test;
+    $className = $theClass->getName();
+
+    return new IncompleteTestCase(
+      $className,
+      $name,
+      sprintf(
+        'Data was invalid for test  className=%s method=%s data=%s argError=%s',
+        $className,
+        $name,
+        json_encode($data),
+        $argError,
+      ),
+    );
+
   }
 
   private static function verifyTestArgumentsFitShapeRequested(
@@ -0,0 +1,271 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestSuite;
+
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestSuite;
+use Zynga\PHPUnit\V2\TestSuite\ResultCache;
+use Zynga\PHPUnit\V2\TestSuite\Scheduler;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
+
+// --
+// Reorders a suite so the tests most likely to tell something run first.
+//
+// Modes are applied in the order given, later ones break the ties of earlier
+// ones:
+//   defects - classes with a test that failed or errored last time
+//   changed - classes whose file was edited since they last ran
+//   fastest - classes expected to take the least time
+//
+// Only whole classes move: the tests of one class stay together and in their
+// declared order, so before/after class hooks and @depends keep working.
+// Nested suites are reordered inside first and then move as one block.
+// Anything the cache or the timings know nothing about keeps its place
+// relative to its neighbours.
+// --
+class TestOrder {
+  const string ORDER_DEFECTS = 'defects';
+  const string ORDER_CHANGED = 'changed';
+  const string ORDER_FASTEST = 'fastest';
+
+  private ImmVector<string> $_modes;
+  private ?ResultCache $_resultCache;
+  private ?TimingDatabase $_timings;
+
+  private Map<string, bool> $_changedClasses;
+  private ?float $_meanTime;
+
+  public function __construct(
+    ImmVector<string> $modes,
+    ?ResultCache $resultCache,
+    ?TimingDatabase $timings,
+  ) {
+    $this->_modes = $modes;
+    $this->_resultCache = $resultCache;
+    $this->_timings = $timings;
+    $this->_changedClasses = Map {};
+    $this->_meanTime = null;
+  }
+
+  // --
+  // Parses a comma separated list of modes, null when any is unknown.
+  // --
+  public static function parseOrder(string $order): ?ImmVector<string> {
+
+    $modes = Vector {};
+
+    foreach (explode(',', $order) as $mode) {
+
+      $mode = trim($mode);
+
+      if ($mode !== self::ORDER_DEFECTS &&
+          $mode !== self::ORDER_CHANGED &&
+          $mode !== self::ORDER_FASTEST) {
+        return null;
+      }
+
+      $modes->add($mode);
+
+    }
+
+    return $modes->toImmVector();
+
+  }
+
+  public function reorder(TestSuite $suite): void {
+
+    $blocks = Vector {};
+    $previousClass = '';
+
+    foreach ($suite->tests() as $test) {
+
+      if ($test instanceof TestSuite) {
+        $this->reorder($test);
+        $blocks->add(Vector {$test});
+        $previousClass = '';
+        continue;
+      }
+
+      $className = get_class($test);
+
+      if ($className === $previousClass && $blocks->count() > 0) {
+        $blocks[$blocks->count() - 1]->add($test);
+      } else {
+        $blocks->add(Vector {$test});
+      }
+
+      $previousClass = $className;
+
+    }
+
+    if ($blocks->count() < 2) {
+      return;
+    }
+
+    $keyed = array();
+
+    foreach ($blocks as $position => $block) {
+      $keyed[] = tuple($this->getKey($block), $position, $block);
+    }
+
+    usort(
+      $keyed,
+      function(
+        (Vector<float>, int, Vector<TestInterface>) $a,
+        (Vector<float>, int, Vector<TestInterface>) $b,
+      ): int {
+        foreach ($a[0] as $offset => $value) {
+          if ($value < $b[0][$offset]) {
+            return -1;
+          }
+          if ($value > $b[0][$offset]) {
+            return 1;
+          }
+        }
+        return $a[1] - $b[1];
+      },
+    );
+
+    $tests = Vector {};
+
+    foreach ($keyed as $entry) {
+      $tests->addAll($entry[2]);
+    }
+
+    $suite->setTests($tests);
+
+  }
+
+  private function getKey(Vector<TestInterface> $block): Vector<float> {
+
+    $tests = Vector {};
+
+    foreach ($block as $test) {
+      if ($test instanceof TestSuite) {
+        $tests->addAll($test->getPlan()->getTests());
+      } else {
+        $tests->add($test);
+      }
+    }
+
+    $key = Vector {};
+
+    foreach ($this->_modes as $mode) {
+      if ($mode === self::ORDER_DEFECTS) {
+        $key->add($this->hasDefect($tests) ? 0.0 : 1.0);
+      } else if ($mode === self::ORDER_CHANGED) {
+        $key->add($this->hasChanged($tests) ? 0.0 : 1.0);
+      } else {
+        $key->add($this->estimate($tests));
+      }
+    }
+
+    return $key;
+
+  }
+
+  private function hasDefect(Vector<TestInterface> $tests): bool {
+
+    $resultCache = $this->_resultCache;
+
+    if (!$resultCache instanceof ResultCache) {
+      return false;
+    }
+
+    foreach ($tests as $test) {
+      if ($test instanceof TestCase &&
+          $resultCache->isDefect($test->getClass(), $test->getName())) {
+        return true;
+      }
+    }
+
+    return false;
+
+  }
+
+  private function hasChanged(Vector<TestInterface> $tests): bool {
+
+    $resultCache = $this->_resultCache;
+
+    if (!$resultCache instanceof ResultCache) {
+      return false;
+    }
+
+    foreach ($tests as $test) {
+
+      $className = get_class($test);
+
+      $isChanged = $this->_changedClasses->get($className);
+
+      if ($isChanged === null) {
+        $isChanged = $resultCache->isClassChanged($className);
+        $this->_changedClasses->set($className, $isChanged);
+      }
+
+      if ($isChanged === true) {
+        return true;
+      }
+
+    }
+
+    return false;
+
+  }
+
+  // --
+  // Expected seconds for the tests, estimated a class at a time the way the
+  // scheduler does. Classes without history are assumed to take the mean
+  // time for each of their tests.
+  // --
+  private function estimate(Vector<TestInterface> $tests): float {
+
+    $timings = $this->_timings;
+
+    if (!$timings instanceof TimingDatabase) {
+      return 0.0;
+    }
+
+    $meanTime = $this->_meanTime;
+
+    if ($meanTime === null) {
+      $meanTime = $timings->getMeanMethodTime();
+      $this->_meanTime = $meanTime;
+    }
+
+    $classPositions = Map {};
+
+    foreach ($tests as $position => $test) {
+      $className = get_class($test);
+      $positions = $classPositions->get($className);
+      if ($positions === null) {
+        $positions = Vector {};
+        $classPositions->set($className, $positions);
+      }
+      $positions->add($position);
+    }
+
+    $scheduler = new Scheduler(1, $timings);
+
+    $total = 0.0;
+
+    foreach ($classPositions as $positions) {
+
+      $estimate = $scheduler->estimate($tests, $positions);
+
+      if ($estimate === null) {
+        $estimate = 0.0;
+        foreach ($positions as $position) {
+          $estimate += $meanTime * $tests[$position]->count();
+        }
+      }
+
+      $total += $estimate;
+
+    }
+
+    return $total;
+
+  }
+
+}
@@ -0,0 +1,208 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\TestSuite;
+
+// --
+// Wall time of every test method from previous runs, keyed by test class.
+//
+// TestResult::endTest() records each test as it completes, save() then
+// writes the times of this run over the recorded ones, leaving the history
+// of tests that did not run this time in place. The scheduler reads it back
+// to estimate how long a class is going to take.
+//
+// It also keeps how many data sets each deferred data provider yielded, so
+// the next run can count those tests before calling the providers.
+// --
+class TimingDatabase {
+  const string FORMAT_VERSION = '2';
+
+  private string $_databaseFile;
+
+  // class => method => seconds
+  private Map<string, Map<string, float>> $_times;
+
+  // class => method => data sets
+  private Map<string, Map<string, int>> $_dataSetCounts;
+
+  public function __construct(string $databaseFile) {
+    $this->_databaseFile = $databaseFile;
+    $this->_times = Map {};
+    $this->_dataSetCounts = Map {};
+  }
+
+  public function getDatabaseFile(): string {
+    return $this->_databaseFile;
+  }
+
+  public function load(): bool {
+
+    if (!is_file($this->_databaseFile)) {
+      return false;
+    }
+
+    $payload = file_get_contents($this->_databaseFile);
+
+    if (!is_string($payload) || $payload == '') {
+      return false;
+    }
+
+    $data = unserialize($payload);
+
+    if (!is_array($data) ||
+        !array_key_exists('version', $data) ||
+        $data['version'] !== self::FORMAT_VERSION ||
+        !array_key_exists('classes', $data) ||
+        !is_array($data['classes'])) {
+      return false;
+    }
+
+    foreach ($data['classes'] as $className => $methods) {
+      if (!is_array($methods)) {
+        continue;
+      }
+      $methodTimes = Map {};
+      foreach ($methods as $methodName => $time) {
+        $methodTimes->set(strval($methodName), floatval($time));
+      }
+      $this->_times->set(strval($className), $methodTimes);
+    }
+
+    if (array_key_exists('dataSets', $data) && is_array($data['dataSets'])) {
+      foreach ($data['dataSets'] as $className => $methods) {
+        if (!is_array($methods)) {
+          continue;
+        }
+        $methodCounts = Map {};
+        foreach ($methods as $methodName => $count) {
+          $methodCounts->set(strval($methodName), intval($count));
+        }
+        $this->_dataSetCounts->set(strval($className), $methodCounts);
+      }
+    }
+
+    return true;
+
+  }
+
+  public function record(string $className, string $methodName, float $time): void {
+
+    $methodTimes = $this->_times->get($className);
+
+    if ($methodTimes === null) {
+      $methodTimes = Map {};
+      $this->_times->set($className, $methodTimes);
+    }
+
+    $methodTimes->set($methodName, $time);
+
+  }
+
+  public function recordDataSetCount(
+    string $className,
+    string $methodName,
+    int $count,
+  ): void {
+
+    $methodCounts = $this->_dataSetCounts->get($className);
+
+    if ($methodCounts === null) {
+      $methodCounts = Map {};
+      $this->_dataSetCounts->set($className, $methodCounts);
+    }
+
+    $methodCounts->set($methodName, $count);
+
+  }
+
+  public function getDataSetCount(string $className, string $methodName): ?int {
+    $methodCounts = $this->_dataSetCounts->get($className);
+    if ($methodCounts === null) {
+      return null;
+    }
+    return $methodCounts->get($methodName);
+  }
+
+  public function hasClass(string $className): bool {
+    return $this->_times->containsKey($className);
+  }
+
+  public function getMethodTime(string $className, string $methodName): ?float {
+    $methodTimes = $this->_times->get($className);
+    if ($methodTimes === null) {
+      return null;
+    }
+    return $methodTimes->get($methodName);
+  }
+
+  public function getClassTime(string $className): float {
+    $total = 0.0;
+    $methodTimes = $this->_times->get($className);
+    if ($methodTimes !== null) {
+      foreach ($methodTimes as $time) {
+        $total += $time;
+      }
+    }
+    return $total;
+  }
+
+  // --
+  // Mean time per recorded method, what a method without history is assumed
+  // to take.
+  // --
+  public function getMeanMethodTime(): float {
+
+    $total = 0.0;
+    $count = 0;
+
+    foreach ($this->_times as $methodTimes) {
+      foreach ($methodTimes as $time) {
+        $total += $time;
+        $count++;
+      }
+    }
+
+    if ($count == 0) {
+      return 0.0;
+    }
+
+    return $total / $count;
+
+  }
+
+  public function save(): bool {
+
+    $classes = array();
+
+    foreach ($this->_times as $className => $methodTimes) {
+      $classes[$className] = $methodTimes->toArray();
+    }
+
+    $dataSets = array();
+
+    foreach ($this->_dataSetCounts as $className => $methodCounts) {
+      $dataSets[$className] = $methodCounts->toArray();
+    }
+
+    $data = array(
+      'version' => self::FORMAT_VERSION,
+      'classes' => $classes,
+      'dataSets' => $dataSets,
+    );
+
+    $databaseDir = dirname($this->_databaseFile);
+
+    if (!is_dir($databaseDir)) {
+      @mkdir($databaseDir, 0755, true);
+    }
+
+    $tmpFile = $this->_databaseFile.'.'.getmypid().'.tmp';
+
+    if (file_put_contents($tmpFile, serialize($data)) === false) {
+      return false;
+    }
+
+    return rename($tmpFile, $this->_databaseFile);
+
+  }
+
+}
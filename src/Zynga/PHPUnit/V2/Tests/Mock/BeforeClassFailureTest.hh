@@ -0,0 +1,24 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\Mock;
+
+use Zynga\PHPUnit\V2\TestCase;
+
+use \Exception;
+
+<<beforeClass("failingClassSetup")>>
+class BeforeClassFailureTest extends TestCase {
+
+  public static function failingClassSetup(): void {
+    throw new Exception('beforeClass hook failed');
+  }
+
+  public function test1(): void {
+    $this->assertTrue(true);
+  }
+
+  public function test2(): void {
+    $this->assertTrue(true);
+  }
+
+}
@@ -0,0 +1,28 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\Mock;
+
+use Zynga\PHPUnit\V2\TestCase;
+
+class GeneratorDataProviderTest extends TestCase {
+  public static int $providerCalls = 0;
+
+  public static function resetProperties(): void {
+    self::$providerCalls = 0;
+  }
+
+  // Expected: two passing data sets and one incomplete for the missing
+  // argument, the provider only being called once the test runs.
+  <<dataProvider("addProvider")>>
+  public function testAdd(int $a, int $b, int $c): void {
+    $this->assertEquals($c, $a + $b);
+  }
+
+  public static function addProvider(): Generator<string, array<int>, void> {
+    self::$providerCalls++;
+    yield 'zero' => array(0, 0, 0);
+    yield 'one' => array(0, 1, 1);
+    yield 'short' => array(1);
+  }
+
+}
@@ -0,0 +1,17 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\Mock;
+
+use Zynga\PHPUnit\V2\TestCase;
+
+class SlowTestCase extends TestCase {
+
+  /**
+   * @small
+   */
+  public function testSleep(): void {
+    sleep(5);
+    $this->assertTrue(true);
+  }
+
+}
@@ -0,0 +1,61 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\Mock;
+
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
+
+// --
+// A plan of four single method classes, OneTestCase repeated, and timings
+// for them, shared by the tests of everything that splits or orders a plan
+// by how long its classes take.
+// --
+class TimedTestPlan {
+
+  public static function createTests(
+    int $oneTestCaseCount,
+  ): Vector<TestInterface> {
+
+    $tests = Vector {};
+
+    $tests->add(new Success('testNoop'));
+
+    for ($i = 0; $i < $oneTestCaseCount; $i++) {
+      $tests->add(new OneTestCase('testCase'));
+    }
+
+    $tests->add(new NoArgTestCase('testNothing'));
+    $tests->add(new WasRun('testWasRun'));
+
+    return $tests;
+
+  }
+
+  // --
+  // Seconds per test keyed by class, classes left out stay untimed.
+  // --
+  public static function createTimings(
+    Map<string, float> $classTimes,
+  ): TimingDatabase {
+
+    $methodNames = Map {
+      Success::class => 'testNoop',
+      OneTestCase::class => 'testCase',
+      NoArgTestCase::class => 'testNothing',
+      WasRun::class => 'testWasRun',
+    };
+
+    $timings = new TimingDatabase('/nonexistent/timings.db');
+
+    foreach ($classTimes as $className => $time) {
+      $methodName = $methodNames->get($className);
+      if ($methodName !== null) {
+        $timings->record($className, $methodName, $time);
+      }
+    }
+
+    return $timings;
+
+  }
+
+}
@@ -0,0 +1,25 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\Mock;
+
+use Zynga\PHPUnit\V2\TestCase;
+
+// --
+// Takes down the process running it, standing in for a worker that
+// crashes halfway through its group. Only armed by the tests forking one.
+// --
+class WorkerExitTestCase extends TestCase {
+  public static bool $exitOnRun = false;
+
+  public function testBeforeExit(): void {
+    $this->assertTrue(true);
+  }
+
+  public function testExit(): void {
+    if (self::$exitOnRun === true) {
+      exit(3);
+    }
+    $this->assertTrue(true);
+  }
+
+}
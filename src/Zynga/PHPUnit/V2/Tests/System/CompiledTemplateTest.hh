@@ -0,0 +1,156 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use SebastianBergmann\TextTemplate\CompiledTemplate;
+use SebastianBergmann\TextTemplate\Template;
+use Zynga\PHPUnit\V2\TestCase;
+
+class CompiledTemplateTest extends TestCase {
+  private Vector<string> $_tempFiles = Vector {};
+
+  public function tearDown(): void {
+    foreach ($this->_tempFiles as $tempFile) {
+      @unlink($tempFile);
+    }
+    $this->_tempFiles->clear();
+  }
+
+  private function getTempFile(): string {
+    $tempFile =
+      sys_get_temp_dir().
+      '/compiled-template-test-'.
+      getmypid().
+      '-'.
+      $this->_tempFiles->count();
+    $this->_tempFiles->add($tempFile);
+    return $tempFile;
+  }
+
+  private function createTemplate(
+    string $body,
+    string $openDelimiter = '{',
+    string $closeDelimiter = '}',
+  ): Template {
+    $templateFile = $this->getTempFile();
+    file_put_contents($templateFile, $body);
+    return new Template($templateFile, $openDelimiter, $closeDelimiter);
+  }
+
+  // --
+  // Renders the body through Template and CompiledTemplate with the same
+  // values, trimmed, untrimmed and written to a file, the output must match.
+  // --
+  private function assertRendersAlike(
+    string $body,
+    Map<string, mixed> $values,
+    string $openDelimiter = '{',
+    string $closeDelimiter = '}',
+  ): void {
+
+    $template = $this->createTemplate($body, $openDelimiter, $closeDelimiter);
+    $compiled = new CompiledTemplate($body, $openDelimiter, $closeDelimiter);
+
+    $this->assertEquals(
+      $template->render($values),
+      $compiled->render($values),
+    );
+    $this->assertEquals(
+      $template->render($values, true),
+      $compiled->render($values, true),
+    );
+
+    $templateTarget = $this->getTempFile();
+    $compiledTarget = $this->getTempFile();
+
+    $template->renderTo($templateTarget, $values);
+    $compiled->renderTo($compiledTarget, $values);
+
+    $this->assertEquals(
+      file_get_contents($templateTarget),
+      file_get_contents($compiledTarget),
+    );
+
+  }
+
+  public function testRendersLikeTemplate(): void {
+
+    $values = Map {'name' => 'Foo', 'count' => 3, 'empty' => ''};
+
+    $this->assertRendersAlike('', $values);
+    $this->assertRendersAlike('no placeholders at all', $values);
+    $this->assertRendersAlike('{name}', $values);
+    $this->assertRendersAlike(
+      "  {name} has {count} tests{empty}, {name} again\n",
+      $values,
+    );
+    $this->assertRendersAlike('{name}{count}{name}', $values);
+    $this->assertRendersAlike('{{name}} and {na{name}}', $values);
+
+  }
+
+  public function testUnknownPlaceholdersAreLeftAsWritten(): void {
+
+    $values = Map {'known' => 'K'};
+
+    $this->assertRendersAlike('{unknown} {known} {also unknown}', $values);
+    $this->assertRendersAlike('{known} {', $values);
+    $this->assertRendersAlike('} {known', $values);
+    $this->assertRendersAlike("body { margin: 0; }\n{known}", $values);
+    $this->assertRendersAlike('{}{known}', $values);
+
+  }
+
+  public function testCustomDelimiters(): void {
+
+    $this->assertRendersAlike(
+      '<%a%> <%b%> <%missing%> <%',
+      Map {'a' => 1, 'b' => 'two'},
+      '<%',
+      '%>',
+    );
+
+  }
+
+  public function testReportTemplatesRenderAlike(): void {
+
+    $templateDir =
+      dirname(dirname(dirname(dirname(dirname(__DIR__))))).
+      '/SebastianBergmann/CodeCoverage/Report/Html/Renderer/Template/';
+
+    $templateFiles = glob($templateDir.'*.html.dist');
+
+    $this->assertGreaterThan(0, count($templateFiles));
+
+    foreach ($templateFiles as $templateFile) {
+
+      $body = file_get_contents($templateFile);
+
+      // a value for every other placeholder, the rest stay unknown.
+      $values = Map {};
+      $slots = (new CompiledTemplate($body))->getSlots();
+      foreach ($slots as $slot => $key) {
+        if ($slot % 2 == 0 && strpos($key, "\n") === false) {
+          $values->set($key, 'value'.$slot);
+        }
+      }
+
+      $this->assertRendersAlike($body, $values);
+
+    }
+
+  }
+
+  public function testValuesAreNotSearchedForPlaceholders(): void {
+
+    // Template::render() would go on to replace {b} inside the value.
+    $compiled = new CompiledTemplate('{a}');
+
+    $this->assertEquals(
+      '{b}',
+      $compiled->render(Map {'a' => '{b}', 'b' => 'x'}),
+    );
+
+  }
+
+}
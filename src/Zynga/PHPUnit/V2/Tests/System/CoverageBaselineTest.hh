@@ -0,0 +1,204 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\CodeBase\V1\CoverageBaseline;
+use Zynga\CodeBase\V1\FileFactory;
+use Zynga\PHPUnit\V2\TestCase;
+
+class CoverageBaselineTest extends TestCase {
+  private Vector<string> $_tempFiles = Vector {};
+
+  public function tearDown(): void {
+    foreach ($this->_tempFiles as $tempFile) {
+      FileFactory::forget($tempFile);
+      @unlink($tempFile);
+    }
+    $this->_tempFiles->clear();
+  }
+
+  private function getTempFile(string $name): string {
+    $tempFile =
+      sys_get_temp_dir().'/coverage-baseline-test-'.getmypid().'-'.$name;
+    $this->_tempFiles->add($tempFile);
+    return $tempFile;
+  }
+
+  private function createSource(string $name): string {
+    $source = $this->getTempFile($name.'.hh');
+    file_put_contents(
+      $source,
+      "<?hh\n\nfunction ".$name."(): int {\n  \$x = 1;\n  return \$x;\n}\n",
+    );
+    return $source;
+  }
+
+  // --
+  // A baseline as a previous run would have saved it.
+  // --
+  private function writeBaseline(
+    string $name,
+    array<string, array<mixed>> $files,
+    array<string, array<string>> $testClasses,
+  ): string {
+    $baselineFile = $this->getTempFile($name.'.baseline');
+    file_put_contents(
+      $baselineFile,
+      serialize(
+        array(
+          'version' => CoverageBaseline::FORMAT_VERSION,
+          'files' => $files,
+          'testClasses' => $testClasses,
+        ),
+      ),
+    );
+    return $baselineFile;
+  }
+
+  // --
+  // Two sources, kept and edited, and one that has gone since. Four test
+  // classes: one only touching the kept source, one touching the edited
+  // one, one whose own file was edited and one touching the gone source.
+  // --
+  private function createBaseline(): (CoverageBaseline, string, string) {
+
+    $kept = $this->createSource('kept');
+    $edited = $this->createSource('edited');
+    $gone = $this->getTempFile('gone.hh');
+
+    $baselineFile = $this->writeBaseline(
+      'selection',
+      array(
+        $kept => array(
+          sha1_file($kept),
+          array(4 => array('KeptTest::testOne', 'OwnFileTest::testTwo')),
+        ),
+        $edited => array('stale', array(4 => array('EditedTest::testOne'))),
+        $gone => array('stale', array(1 => array('GoneTest::testOne'))),
+      ),
+      array(
+        'KeptTest' => array($kept, sha1_file($kept)),
+        'EditedTest' => array($kept, sha1_file($kept)),
+        'OwnFileTest' => array($edited, 'stale'),
+        'GoneTest' => array($kept, sha1_file($kept)),
+      ),
+    );
+
+    $baseline = new CoverageBaseline($baselineFile);
+
+    $this->assertTrue($baseline->load());
+
+    $baseline->computeSelection(Vector {$kept, $edited});
+
+    return tuple($baseline, $kept, $edited);
+
+  }
+
+  public function testSelectionFollowsChangedFiles(): void {
+
+    list($baseline, $kept, $edited) = $this->createBaseline();
+
+    $changedFiles = $baseline->getChangedFiles()->toArray();
+    sort($changedFiles);
+
+    $expectedFiles = array($edited, $this->getTempFile('gone.hh'));
+    sort($expectedFiles);
+
+    $this->assertEquals($expectedFiles, $changedFiles);
+
+    $this->assertFalse($baseline->isTestClassSelected('KeptTest'));
+    $this->assertTrue($baseline->isTestClassSelected('EditedTest'));
+    $this->assertTrue($baseline->isTestClassSelected('OwnFileTest'));
+    $this->assertTrue($baseline->isTestClassSelected('GoneTest'));
+
+    // nothing is known about what a new class covers.
+    $this->assertTrue($baseline->isTestClassSelected('NewTest'));
+
+  }
+
+  public function testMergeIntoRestoresTheClassesNotRunAgain(): void {
+
+    list($baseline, $kept, $edited) = $this->createBaseline();
+
+    $baseline->mergeInto();
+
+    // the selected class is left for this run to attribute again.
+    $this->assertEquals(
+      Vector {'KeptTest::testOne'},
+      FileFactory::get($kept)->lineToTests()->getTestNames(4),
+    );
+
+    // the edited source is left alone entirely.
+    $this->assertFalse(FileFactory::isFileRegistered($edited));
+
+  }
+
+  public function testMergeIsTheUnionOfBothBaselines(): void {
+
+    $source = $this->createSource('shared');
+    $other = $this->createSource('other');
+
+    $first = new CoverageBaseline(
+      $this->writeBaseline(
+        'first',
+        array(
+          $source => array('hash', array(4 => array('ATest::testOne'))),
+        ),
+        array('ATest' => array($source, 'a')),
+      ),
+    );
+
+    $second = new CoverageBaseline(
+      $this->writeBaseline(
+        'second',
+        array(
+          $source => array(
+            'hash',
+            array(
+              4 => array('ATest::testOne', 'BTest::testOne'),
+              5 => array('BTest::testOne'),
+            ),
+          ),
+          $other => array('other', array(3 => array('BTest::testTwo'))),
+        ),
+        array('ATest' => array($source, 'b'), 'BTest' => array($other, 'b')),
+      ),
+    );
+
+    $this->assertTrue($first->load());
+    $this->assertTrue($second->load());
+
+    $first->merge($second);
+
+    $mergedFile = $this->getTempFile('merged.baseline');
+
+    $merged = new CoverageBaseline($mergedFile);
+    $merged->merge($first);
+
+    $this->assertTrue($merged->saveMerged());
+
+    $this->assertEquals(
+      array(
+        'version' => CoverageBaseline::FORMAT_VERSION,
+        'files' => array(
+          $source => array(
+            'hash',
+            array(
+              4 => array('ATest::testOne', 'BTest::testOne'),
+              5 => array('BTest::testOne'),
+            ),
+          ),
+          $other => array('other', array(3 => array('BTest::testTwo'))),
+        ),
+        // a class both know keeps what the first recorded.
+        'testClasses' => array(
+          'ATest' => array($source, 'a'),
+          'BTest' => array($other, 'b'),
+        ),
+      ),
+      unserialize(file_get_contents($mergedFile)),
+    );
+
+  }
+
+}
@@ -0,0 +1,82 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestSuite\DiscoveryIndex;
+use Zynga\PHPUnit\V2\Tests\Mock\InheritedTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\OneTestCase;
+
+class DiscoveryIndexTest extends TestCase {
+
+  private function getMockFile(string $name): string {
+    return dirname(__DIR__).'/Mock/'.$name.'.hh';
+  }
+
+  private function getIndexFile(): string {
+    return sys_get_temp_dir().'/discovery-index-test-'.getmypid().'.idx';
+  }
+
+  public function tearDown(): void {
+    @unlink($this->getIndexFile());
+  }
+
+  public function testScanFindsConcreteClasses(): void {
+
+    $index = new DiscoveryIndex($this->getIndexFile());
+
+    $this->assertEquals(
+      Vector {OneTestCase::class},
+      $index->getClasses($this->getMockFile('OneTestCase')),
+    );
+
+    $this->assertEquals(
+      Vector {InheritedTestCase::class},
+      $index->getClasses($this->getMockFile('InheritedTestCase')),
+    );
+
+    $this->assertTrue($index->isDirty());
+
+  }
+
+  public function testFilesWithoutConcreteClassesAreNotIncluded(): void {
+
+    $sourceFile = sys_get_temp_dir().'/discovery-abstract-'.getmypid().'.hh';
+
+    file_put_contents(
+      $sourceFile,
+      "<?hh // strict\n\nnamespace Discovery;\n\nabstract class BaseTest {}\n",
+    );
+
+    $index = new DiscoveryIndex($this->getIndexFile());
+
+    $this->assertEquals(Vector {}, $index->getClasses($sourceFile));
+    $this->assertFalse($index->needsInclude($sourceFile));
+    $this->assertTrue($index->needsInclude($this->getMockFile('OneTestCase')));
+
+    @unlink($sourceFile);
+
+  }
+
+  public function testSavedIndexIsReused(): void {
+
+    $mockFile = $this->getMockFile('OneTestCase');
+
+    $index = new DiscoveryIndex($this->getIndexFile());
+    $index->getClasses($mockFile);
+
+    $this->assertTrue($index->save());
+    $this->assertFalse($index->isDirty());
+
+    $reloaded = new DiscoveryIndex($this->getIndexFile());
+
+    $this->assertTrue($reloaded->load());
+    $this->assertEquals(
+      Vector {OneTestCase::class},
+      $reloaded->getClasses($mockFile),
+    );
+    $this->assertFalse($reloaded->isDirty());
+
+  }
+
+}
@@ -0,0 +1,75 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestSuite;
+use Zynga\PHPUnit\V2\Tests\Mock\InheritedTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\OneTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\Success;
+
+class ExecutionPlanTest extends TestCase {
+
+  private function createSuite(): TestSuite {
+    $suite = new TestSuite();
+    $suite->addTestSuite(OneTestCase::class);
+    $suite->addTestSuite(InheritedTestCase::class);
+    return $suite;
+  }
+
+  public function testPlanFlattensTheSuiteTree(): void {
+
+    $plan = $this->createSuite()->getPlan();
+
+    $this->assertEquals(3, $plan->getTestCount());
+    $this->assertEquals(3, $plan->count());
+
+    $this->assertInstanceOf(OneTestCase::class, $plan->getFirstTest());
+    $this->assertInstanceOf(InheritedTestCase::class, $plan->getLastTest());
+
+    $this->assertEquals(
+      ImmVector {tuple(0, 0), tuple(1, 2)},
+      $plan->getClassRanges(),
+    );
+
+    $this->assertEquals(
+      Vector {Vector {0}, Vector {1, 2}},
+      $plan->getClassGroups(),
+    );
+
+  }
+
+  public function testPlanIsKeptUntilTheTestsChange(): void {
+
+    $suite = $this->createSuite();
+
+    $plan = $suite->getPlan();
+
+    $this->assertSame($plan, $suite->getPlan());
+
+    $suite->addTest(new Success('testNoop'));
+
+    $this->assertNotSame($plan, $suite->getPlan());
+    $this->assertEquals(4, $suite->count());
+
+  }
+
+  public function testPlanListsTheGroupsOfTheSuites(): void {
+
+    $suite = new TestSuite();
+    $suite->addTest(new Success('testNoop'));
+    $suite->addTest(new OneTestCase('testCase'), array('one'));
+
+    $plan = $suite->getPlan();
+
+    $groupNames = $plan->getGroupNames()->toArray();
+    sort($groupNames);
+
+    // the ungrouped test is filed under 'default' by the suite.
+    $this->assertEquals(array('default', 'one'), $groupNames);
+    $this->assertEquals(ImmVector {0}, $plan->getGroupPositions('default'));
+    $this->assertEquals(ImmVector {1}, $plan->getGroupPositions('one'));
+
+  }
+
+}
@@ -0,0 +1,97 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\FileAnalyzerPool;
+use Zynga\CodeBase\V1\FileCache;
+use Zynga\CodeBase\V1\FileFactory;
+use Zynga\PHPUnit\V2\TestCase;
+
+class FileAnalyzerPoolTest extends TestCase {
+  private string $_previousCacheDir = '';
+  private Vector<string> $_copies = Vector {};
+
+  public function setUp(): void {
+    // cache hits would never reach the workers.
+    $this->_previousCacheDir = FileCache::getCacheDir();
+    FileCache::setCacheDir('');
+  }
+
+  public function tearDown(): void {
+    foreach ($this->_copies as $copy) {
+      FileFactory::forget($copy);
+      @unlink($copy);
+    }
+    $this->_copies->clear();
+    FileCache::setCacheDir($this->_previousCacheDir);
+  }
+
+  // --
+  // Copies of sources nothing else has analyzed, so the coverage of the
+  // running suite cannot have touched their line states.
+  // --
+  private function createSources(): Vector<string> {
+
+    $sources = Vector {
+      dirname(__DIR__).'/Mock/OneTestCase.hh',
+      dirname(__DIR__).'/Mock/BeforeClassFailureTest.hh',
+      dirname(__DIR__).'/Mock/GeneratorDataProviderTest.hh',
+      __DIR__.'/LineExecutionStateTest.hh',
+    };
+
+    foreach ($sources as $offset => $source) {
+      $copy =
+        sys_get_temp_dir().
+        '/file-analyzer-pool-'.
+        getmypid().
+        '-'.
+        $offset.
+        '.hh';
+      copy($source, $copy);
+      $this->_copies->add($copy);
+    }
+
+    return $this->_copies;
+
+  }
+
+  public function testPoolMatchesSerialAnalysis(): void {
+
+    $filenames = $this->createSources();
+
+    $pool = new FileAnalyzerPool(2);
+
+    $analyzed = Map {};
+    foreach ($pool->analyze($filenames) as $file) {
+      $analyzed->set($file->getFile(), $file);
+    }
+
+    $this->assertEquals($filenames->count(), $analyzed->count());
+
+    foreach ($filenames as $filename) {
+
+      $pooled = $analyzed->get($filename);
+
+      $this->assertInstanceOf(File::class, $pooled);
+
+      if (!$pooled instanceof File) {
+        continue;
+      }
+
+      $serial = FileFactory::get($filename);
+
+      $this->assertEquals(
+        $serial->analysis()->export(),
+        $pooled->analysis()->export(),
+      );
+      $this->assertEquals(
+        $serial->lineExecutionState()->getAll()->toArray(),
+        $pooled->lineExecutionState()->getAll()->toArray(),
+      );
+
+    }
+
+  }
+
+}
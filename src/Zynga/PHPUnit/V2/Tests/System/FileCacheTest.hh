@@ -0,0 +1,124 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\FileCache;
+use Zynga\PHPUnit\V2\TestCase;
+
+class FileCacheTest extends TestCase {
+  private string $_previousCacheDir = '';
+
+  private function getCacheDir(): string {
+    return sys_get_temp_dir().'/file-cache-test-'.getmypid();
+  }
+
+  private function getSourceFile(): string {
+    return $this->getCacheDir().'-source.hh';
+  }
+
+  public function setUp(): void {
+
+    // the running suite may cache its own files, put it back afterwards.
+    $this->_previousCacheDir = FileCache::getCacheDir();
+
+    FileCache::setCacheDir($this->getCacheDir());
+
+    file_put_contents(
+      $this->getSourceFile(),
+      "<?hh // strict\n\n".
+      "class FileCacheSample {\n".
+      "  public function run(int \$a): int {\n".
+      "    if (\$a > 1) {\n".
+      "      return \$a;\n".
+      "    }\n".
+      "    return 0;\n".
+      "  }\n".
+      "}\n",
+    );
+
+  }
+
+  public function tearDown(): void {
+    FileCache::clear();
+    @rmdir($this->getCacheDir());
+    @unlink($this->getSourceFile());
+    FileCache::setCacheDir($this->_previousCacheDir);
+  }
+
+  private function createFile(): File {
+    $file = new File($this->getSourceFile());
+    $file->source()->load();
+    return $file;
+  }
+
+  public function testSavedAnalysisLoadsBackTheSame(): void {
+
+    $analyzed = $this->createFile();
+    $analyzed->init();
+
+    $this->assertTrue(is_file(FileCache::getCacheFile($analyzed)));
+
+    $cached = $this->createFile();
+
+    $this->assertTrue(FileCache::load($cached));
+    $this->assertTrue($cached->isHydrated());
+
+    $this->assertEquals(
+      $analyzed->analysis()->export(),
+      $cached->analysis()->export(),
+    );
+    $this->assertEquals(
+      $analyzed->lineExecutionState()->getAll()->toArray(),
+      $cached->lineExecutionState()->getAll()->toArray(),
+    );
+
+  }
+
+  public function testEditedSourceIsAnalyzedAgain(): void {
+
+    $this->createFile()->init();
+
+    file_put_contents(
+      $this->getSourceFile(),
+      "function fileCacheSample(): void {}\n",
+      FILE_APPEND,
+    );
+
+    $edited = $this->createFile();
+
+    $this->assertFalse(FileCache::load($edited));
+    $this->assertFalse($edited->isHydrated());
+
+  }
+
+  public function testAnalyzerVersionBumpDropsEntries(): void {
+
+    $file = $this->createFile();
+    $file->init();
+
+    $cacheFile = FileCache::getCacheFile($file);
+
+    // an entry as the previous analyzer would have written it.
+    $entry = unserialize(file_get_contents($cacheFile));
+    $this->assertTrue(is_array($entry));
+    $entry['version'] = FileCache::ANALYZER_VERSION.'-previous';
+    file_put_contents($cacheFile, serialize($entry));
+
+    $this->assertFalse(FileCache::load($this->createFile()));
+
+  }
+
+  public function testDisabledCacheNeitherLoadsNorSaves(): void {
+
+    FileCache::setCacheDir('');
+
+    $file = $this->createFile();
+
+    $this->assertFalse(FileCache::isEnabled());
+    $this->assertFalse(FileCache::save($file));
+    $this->assertFalse(FileCache::load($file));
+
+  }
+
+}
@@ -0,0 +1,305 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use SebastianBergmann\CodeCoverage\Driver;
+use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\File\ExecutableRange;
+use Zynga\CodeBase\V1\File\LineExecutionState;
+use Zynga\PHPUnit\V2\TestCase;
+
+class LineExecutionStateTest extends TestCase {
+
+  private function createState(): LineExecutionState {
+    return new LineExecutionState(new File(__FILE__));
+  }
+
+  private function getReasons(Vector<ExecutableRange> $ranges): Vector<string> {
+    $reasons = Vector {};
+    foreach ($ranges as $range) {
+      $reasons->add($range->getReason());
+    }
+    return $reasons;
+  }
+
+  private function toSortedArray(Map<int, int> $states): array<int, int> {
+    $sorted = $states->toArray();
+    ksort($sorted);
+    return $sorted;
+  }
+
+  // --
+  // set() as it was when line states were kept in a Map<int, int>.
+  // --
+  private function legacySet(
+    Map<int, int> $states,
+    int $lineNo,
+    int $lineState,
+  ): void {
+
+    if ($lineState !== Driver::LINE_NOT_EXECUTABLE &&
+        $lineState !== Driver::LINE_NOT_EXECUTED &&
+        $lineState !== Driver::LINE_EXECUTED) {
+      return;
+    }
+
+    $currentValue = $states->get($lineNo);
+
+    if ($currentValue === Driver::LINE_NOT_EXECUTABLE) {
+      return;
+    }
+
+    if ($currentValue !== null && $currentValue > $lineState) {
+      return;
+    }
+
+    $states->set($lineNo, $lineState);
+
+  }
+
+  // --
+  // Builds the ranges the tests below mark lines against: nested,
+  // overlapping, finite and one spanning a not executable line.
+  // --
+  private function addRanges(LineExecutionState $state): void {
+    $state->addExecutableRange('outer', 10, 20);
+    $state->addExecutableRange('nested', 12, 14);
+    $state->addExecutableRange('overlap', 18, 25);
+    $state->addFiniteExecutableRange('finite', 30, 31, 35);
+    $state->addExecutableRange('tail', 40, 44);
+  }
+
+  // --
+  // markExecuted() as it was before ranges were expanded in bulk: the line
+  // and every line of every range applying to it set one by one.
+  // --
+  private function legacyMarkExecuted(
+    LineExecutionState $state,
+    int $lineNo,
+  ): void {
+
+    $state->set($lineNo, Driver::LINE_EXECUTED);
+
+    foreach ($state->getExecutableRanges($lineNo) as $executableRange) {
+      for ($innerLine = $executableRange->getStart();
+           $innerLine <= $executableRange->getEnd();
+           $innerLine++) {
+        $state->set($innerLine, Driver::LINE_EXECUTED);
+      }
+    }
+
+  }
+
+  public function testMarkExecutedLinesMatchesPerLineSet(): void {
+
+    // what each test of a run reports, run one after the other.
+    $runs = Vector {
+      Vector {1, 13, 19, 30},
+      Vector {13, 13, 22, 50},
+      Vector {42, 11, 30, 2},
+    };
+
+    $legacy = $this->createState();
+    $batched = $this->createState();
+
+    foreach (array($legacy, $batched) as $state) {
+      $this->addRanges($state);
+      $state->set(2, Driver::LINE_NOT_EXECUTABLE);
+      $state->set(15, Driver::LINE_NOT_EXECUTABLE);
+      $state->set(43, Driver::LINE_NOT_EXECUTED);
+      $state->set(60, Driver::LINE_NOT_EXECUTED);
+    }
+
+    foreach ($runs as $lineNos) {
+
+      foreach ($lineNos as $lineNo) {
+        $this->legacyMarkExecuted($legacy, $lineNo);
+      }
+
+      $batched->markExecutedLines($lineNos);
+
+      $this->assertEquals(
+        $this->toSortedArray($legacy->getAll()),
+        $this->toSortedArray($batched->getAll()),
+      );
+
+    }
+
+    // not executable lines inside a range stay that way.
+    $this->assertEquals(Driver::LINE_NOT_EXECUTABLE, $batched->get(15));
+    $this->assertEquals(Driver::LINE_NOT_EXECUTED, $batched->get(60));
+    $this->assertEquals(Driver::LINE_EXECUTED, $batched->get(35));
+
+  }
+
+  public function testMarkExecutedSeesRangesAddedAfterApplying(): void {
+
+    $state = $this->createState();
+
+    $state->addExecutableRange('first', 1, 3);
+    $state->markExecuted(2);
+
+    // a range added later must still be expanded, the applied ones skipped.
+    $state->addExecutableRange('second', 2, 6);
+    $state->markExecuted(2);
+
+    $this->assertEquals(
+      array(
+        1 => Driver::LINE_EXECUTED,
+        2 => Driver::LINE_EXECUTED,
+        3 => Driver::LINE_EXECUTED,
+        4 => Driver::LINE_EXECUTED,
+        5 => Driver::LINE_EXECUTED,
+        6 => Driver::LINE_EXECUTED,
+      ),
+      $this->toSortedArray($state->getAll()),
+    );
+
+  }
+
+  public function testLineZeroIsKept(): void {
+
+    $state = $this->createState();
+
+    $this->assertNull($state->get(0));
+
+    $state->set(0, Driver::LINE_NOT_EXECUTED);
+    $this->assertEquals(Driver::LINE_NOT_EXECUTED, $state->get(0));
+
+    $state->set(0, Driver::LINE_EXECUTED);
+    $this->assertEquals(Driver::LINE_EXECUTED, $state->get(0));
+
+    $this->assertNull($state->get(1));
+    $this->assertEquals(
+      array(0 => Driver::LINE_EXECUTED),
+      $this->toSortedArray($state->getAll()),
+    );
+
+  }
+
+  public function testNegativeLinesAreIgnored(): void {
+
+    $state = $this->createState();
+
+    $state->set(-1, Driver::LINE_EXECUTED);
+    $state->markExecuted(-5);
+
+    $this->assertNull($state->get(-1));
+    $this->assertNull($state->get(-5));
+    $this->assertEquals(0, $state->getAll()->count());
+
+  }
+
+  public function testOverlappingAndNestedRanges(): void {
+
+    $state = $this->createState();
+
+    $state->addExecutableRange('outer', 10, 20);
+    $state->addExecutableRange('nested', 12, 14);
+    $state->addExecutableRange('overlap', 18, 25);
+
+    // nothing to span, never registered.
+    $state->addExecutableRange('empty', 30, 29);
+
+    $this->assertEquals(
+      Vector {'outer', 'nested'},
+      $this->getReasons($state->getExecutableRanges(13)),
+    );
+    $this->assertEquals(
+      Vector {'outer', 'overlap'},
+      $this->getReasons($state->getExecutableRanges(19)),
+    );
+    $this->assertEquals(
+      Vector {'overlap'},
+      $this->getReasons($state->getExecutableRanges(22)),
+    );
+
+    $this->assertFalse($state->isLineWithinExecutableRange(9));
+    $this->assertTrue($state->isLineWithinExecutableRange(10));
+    $this->assertTrue($state->isLineWithinExecutableRange(25));
+    $this->assertFalse($state->isLineWithinExecutableRange(26));
+    $this->assertFalse($state->isLineWithinExecutableRange(29));
+    $this->assertFalse($state->isLineWithinExecutableRange(30));
+
+    $this->assertEquals(
+      Vector {'outer', 'nested'},
+      $this->getReasons($state->getAllExecutableRanges()[12]),
+    );
+
+  }
+
+  public function testRangeLookupBeforeAndAfterSorting(): void {
+
+    $state = $this->createState();
+
+    $state->addExecutableRange('late', 30, 40);
+    $this->assertTrue($state->isLineWithinExecutableRange(35));
+
+    // added out of order after the first lookup sorted the ranges.
+    $state->addExecutableRange('early', 5, 8);
+    $this->assertTrue($state->isLineWithinExecutableRange(6));
+    $this->assertTrue($state->isLineWithinExecutableRange(35));
+    $this->assertFalse($state->isLineWithinExecutableRange(9));
+
+    // a wide range that starts first must still be found past the others.
+    $state->addExecutableRange('wide', 1, 50);
+    $this->assertEquals(
+      Vector {'late', 'wide'},
+      $this->getReasons($state->getExecutableRanges(35)),
+    );
+    $this->assertEquals(
+      Vector {'wide'},
+      $this->getReasons($state->getExecutableRanges(45)),
+    );
+
+    // a finite range is only registered against the line it is given for.
+    $state->addFiniteExecutableRange('finite', 60, 60, 64);
+    $this->assertTrue($state->isLineWithinExecutableRange(60));
+    $this->assertFalse($state->isLineWithinExecutableRange(61));
+
+  }
+
+  public function testGetAllMatchesMapSemantics(): void {
+
+    $steps = Vector {
+      tuple(3, Driver::LINE_NOT_EXECUTED),
+      tuple(1, Driver::LINE_NOT_EXECUTABLE),
+      tuple(1, Driver::LINE_EXECUTED),
+      tuple(3, Driver::LINE_EXECUTED),
+      tuple(3, Driver::LINE_NOT_EXECUTED),
+      tuple(7, 0),
+      tuple(8, 5),
+      tuple(0, Driver::LINE_NOT_EXECUTED),
+      tuple(250, Driver::LINE_NOT_EXECUTED),
+      tuple(4, Driver::LINE_EXECUTED),
+      tuple(4, Driver::LINE_NOT_EXECUTABLE),
+      tuple(12, Driver::LINE_NOT_EXECUTABLE),
+      tuple(12, Driver::LINE_NOT_EXECUTED),
+      tuple(250, Driver::LINE_EXECUTED),
+    };
+
+    $legacy = Map {};
+    $state = $this->createState();
+
+    foreach ($steps as $step) {
+      list($lineNo, $lineState) = $step;
+      $this->legacySet($legacy, $lineNo, $lineState);
+      $state->set($lineNo, $lineState);
+    }
+
+    $this->assertEquals(
+      $this->toSortedArray($legacy),
+      $this->toSortedArray($state->getAll()),
+    );
+
+    foreach ($legacy as $lineNo => $lineState) {
+      $this->assertEquals($lineState, $state->get($lineNo));
+    }
+
+    // gaps in the packed storage read back as unset.
+    $this->assertNull($state->get(100));
+    $this->assertNull($state->get(251));
+
+  }
+
+}
@@ -0,0 +1,105 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\File\LineToTests;
+use Zynga\CodeBase\V1\TestIds;
+use Zynga\PHPUnit\V2\TestCase;
+
+class LineToTestsTest extends TestCase {
+
+  private function createLineToTests(): LineToTests {
+    return new LineToTests(new File(__FILE__));
+  }
+
+  // TestIds is shared with the coverage of the running suite, so these
+  // only ever add names of their own and never clear it.
+  public function testInternHandsOutOneIdPerName(): void {
+
+    $before = TestIds::count();
+
+    $first = TestIds::intern(__METHOD__.'::one');
+    $second = TestIds::intern(__METHOD__.'::two');
+
+    $this->assertEquals($before, $first);
+    $this->assertEquals($before + 1, $second);
+    $this->assertEquals($first, TestIds::intern(__METHOD__.'::one'));
+    $this->assertEquals($before + 2, TestIds::count());
+
+    $this->assertEquals(__METHOD__.'::two', TestIds::getName($second));
+    $this->assertEquals('', TestIds::getName(TestIds::count()));
+
+  }
+
+  public function testAppendedIdsRoundTrip(): void {
+
+    $lineToTests = $this->createLineToTests();
+
+    for ($testId = 0; $testId < 300; $testId++) {
+      $lineToTests->add(7, $testId);
+    }
+
+    $testIds = $lineToTests->getTestIds(7);
+
+    $this->assertEquals(300, $testIds->count());
+
+    foreach ($testIds as $offset => $testId) {
+      $this->assertEquals($offset, $testId);
+    }
+
+  }
+
+  public function testOutOfOrderAndDuplicateIdsStaySorted(): void {
+
+    $lineToTests = $this->createLineToTests();
+
+    foreach (array(5, 9, 2, 9, 7, 5, 0, 70000, 2) as $testId) {
+      $lineToTests->add(3, $testId);
+    }
+
+    $this->assertEquals(
+      Vector {0, 2, 5, 7, 9, 70000},
+      $lineToTests->getTestIds(3),
+    );
+
+  }
+
+  public function testLinesAreKeptApart(): void {
+
+    $lineToTests = $this->createLineToTests();
+
+    $lineToTests->add(1, 4);
+    $lineToTests->add(2, 1);
+    $lineToTests->add(1, 3);
+
+    $this->assertEquals(Vector {3, 4}, $lineToTests->getTestIds(1));
+    $this->assertEquals(Vector {1}, $lineToTests->getTestIds(2));
+    $this->assertEquals(Vector {}, $lineToTests->getTestIds(5));
+
+    $lines = $lineToTests->getLines()->toArray();
+    sort($lines);
+
+    $this->assertEquals(array(1, 2), $lines);
+
+  }
+
+  public function testNamesResolveThroughTestIds(): void {
+
+    $lineToTests = $this->createLineToTests();
+
+    $two = TestIds::intern(__METHOD__.'::two');
+    $one = TestIds::intern(__METHOD__.'::one');
+
+    $lineToTests->add(10, $one);
+    $lineToTests->add(10, $two);
+    $lineToTests->add(10, $one);
+
+    $this->assertEquals(
+      Vector {__METHOD__.'::two', __METHOD__.'::one'},
+      $lineToTests->getTestNames(10),
+    );
+
+  }
+
+}
@@ -0,0 +1,141 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestResult;
+use Zynga\PHPUnit\V2\TestSuite;
+use Zynga\PHPUnit\V2\TestSuite\ParallelRunner;
+use Zynga\PHPUnit\V2\Tests\Mock\BeforeClassAndAfterClassTest;
+use Zynga\PHPUnit\V2\Tests\Mock\BeforeClassFailureTest;
+use Zynga\PHPUnit\V2\Tests\Mock\Failure;
+use Zynga\PHPUnit\V2\Tests\Mock\GeneratorDataProviderTest;
+use Zynga\PHPUnit\V2\Tests\Mock\Success;
+use Zynga\PHPUnit\V2\Tests\Mock\WorkerExitTestCase;
+
+class ParallelRunnerTest extends TestCase {
+
+  private function createSuite(): TestSuite {
+    $suite = new TestSuite();
+    $suite->setTests(
+      Vector {
+        new Success('testNoop'),
+        new BeforeClassFailureTest('test1'),
+        new BeforeClassFailureTest('test2'),
+        new Failure('testFailure'),
+        new BeforeClassAndAfterClassTest('test1'),
+        new BeforeClassAndAfterClassTest('test2'),
+      },
+    );
+    return $suite;
+  }
+
+  public function testWorkersReplayEveryGroupInPlanOrder(): void {
+
+    if (ParallelRunner::isSupported() !== true) {
+      $this->markTestSkipped('pcntl is needed to fork workers');
+    }
+
+    $suite = $this->createSuite();
+
+    $result = new TestResult();
+    $result->setWorkers(2);
+
+    $suite->run($result);
+
+    $this->assertEquals(6, $result->count());
+
+    // the failing hook takes down its own class only.
+    $this->assertEquals(2, $result->errorCount());
+    $this->assertEquals(1, $result->failureCount());
+    $this->assertEquals(3, $result->passed()->count());
+
+    $this->assertTrue(
+      $result->passed()->containsKey(Success::class.'::testNoop'),
+    );
+    $this->assertTrue(
+      $result->passed()
+        ->containsKey(BeforeClassAndAfterClassTest::class.'::test2'),
+    );
+
+    $this->assertEquals(
+      Failure::class.'::testFailure',
+      $result->failures()[0]->getTestName(),
+    );
+
+  }
+
+  public function testWorkersStreamDataProviders(): void {
+
+    if (ParallelRunner::isSupported() !== true) {
+      $this->markTestSkipped('pcntl is needed to fork workers');
+    }
+
+    GeneratorDataProviderTest::resetProperties();
+
+    $suite = new TestSuite();
+    $suite->setTests(
+      Vector {
+        new Success('testNoop'),
+        new TestSuite(GeneratorDataProviderTest::class),
+      },
+    );
+
+    $result = new TestResult();
+    $result->setWorkers(2);
+
+    $suite->run($result);
+
+    // the provider is only ever called by the worker claiming its class.
+    $this->assertEquals(0, GeneratorDataProviderTest::$providerCalls);
+
+    $this->assertEquals(4, $result->count());
+    $this->assertEquals(4, $suite->count());
+    $this->assertEquals(1, $result->notImplementedCount());
+    $this->assertEquals(0, $result->errorCount());
+    $this->assertEquals(0, $result->failureCount());
+
+  }
+
+  public function testGroupOfACrashedWorkerIsReportedLost(): void {
+
+    if (ParallelRunner::isSupported() !== true) {
+      $this->markTestSkipped('pcntl is needed to fork workers');
+    }
+
+    $suite = new TestSuite();
+    $suite->setTests(
+      Vector {
+        new WorkerExitTestCase('testBeforeExit'),
+        new WorkerExitTestCase('testExit'),
+        new Success('testNoop'),
+      },
+    );
+
+    $result = new TestResult();
+    $result->setWorkers(2);
+
+    // inherited by the workers, the parent never runs the test itself.
+    WorkerExitTestCase::$exitOnRun = true;
+
+    try {
+      $suite->run($result);
+    } finally {
+      WorkerExitTestCase::$exitOnRun = false;
+    }
+
+    $this->assertEquals(3, $result->count());
+
+    // the whole class is lost with its worker, the others still report.
+    $this->assertEquals(2, $result->errorCount());
+    $this->assertEquals(
+      WorkerExitTestCase::class.'::testBeforeExit',
+      $result->errors()[0]->getTestName(),
+    );
+    $this->assertTrue(
+      $result->passed()->containsKey(Success::class.'::testNoop'),
+    );
+
+  }
+
+}
@@ -0,0 +1,93 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\PHPUnit\V2\RunnerDaemon;
+use Zynga\PHPUnit\V2\RunnerDaemon\OutputReader;
+use Zynga\PHPUnit\V2\TestCase;
+
+class RunnerDaemonTest extends TestCase {
+
+  // --
+  // Feeds the stream to a reader in chunks of $chunkSize, returns all the
+  // output it handed on and the exit code.
+  // --
+  private function readInChunks(string $stream, int $chunkSize): (string, ?int) {
+
+    $reader = new OutputReader();
+    $output = '';
+
+    for ($offset = 0; $offset < strlen($stream); $offset += $chunkSize) {
+      $output .= $reader->feed(substr($stream, $offset, $chunkSize));
+    }
+
+    list($rest, $exitCode) = $reader->finish();
+
+    return tuple($output.$rest, $exitCode);
+
+  }
+
+  public function testExitMarkerIsFoundWhereverTheReadsSplitIt(): void {
+
+    $runOutput = "PHPUnit 5.7\n\n...F\n\nFAILURES!\n";
+    $stream = $runOutput.RunnerDaemon::EXIT_MARKER."1\n";
+
+    for ($chunkSize = 1; $chunkSize <= strlen($stream); $chunkSize++) {
+      list($output, $exitCode) = $this->readInChunks($stream, $chunkSize);
+      $this->assertEquals($runOutput, $output);
+      $this->assertEquals(1, $exitCode);
+    }
+
+  }
+
+  public function testOutputShorterThanTheMarker(): void {
+
+    list($output, $exitCode) =
+      $this->readInChunks('.'.RunnerDaemon::EXIT_MARKER."0\n", 3);
+
+    $this->assertEquals('.', $output);
+    $this->assertEquals(0, $exitCode);
+
+  }
+
+  public function testStreamWithoutMarkerHasNoExitCode(): void {
+
+    list($output, $exitCode) = $this->readInChunks("partial output\n", 4);
+
+    $this->assertEquals("partial output\n", $output);
+    $this->assertNull($exitCode);
+
+    // a marker cut off before its code does not count either.
+    list($output, $exitCode) =
+      $this->readInChunks('..'.RunnerDaemon::EXIT_MARKER, 5);
+
+    $this->assertEquals('..', $output);
+    $this->assertNull($exitCode);
+
+  }
+
+  public function testRequestArgvMustBeStrings(): void {
+
+    $this->assertEquals(
+      Vector {'phpunit', '--filter', 'testFoo'},
+      RunnerDaemon::getRequestArgv(
+        array('argv' => array('phpunit', '--filter', 'testFoo')),
+      ),
+    );
+
+    $this->assertNull(RunnerDaemon::getRequestArgv(array()));
+    $this->assertNull(
+      RunnerDaemon::getRequestArgv(array('argv' => 'phpunit --debug')),
+    );
+    $this->assertNull(
+      RunnerDaemon::getRequestArgv(array('argv' => array('phpunit', 1))),
+    );
+    $this->assertNull(
+      RunnerDaemon::getRequestArgv(
+        array('argv' => array('phpunit', array('--bootstrap'))),
+      ),
+    );
+
+  }
+
+}
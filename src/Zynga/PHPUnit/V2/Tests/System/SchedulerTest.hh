@@ -0,0 +1,82 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestSuite\Scheduler;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
+use Zynga\PHPUnit\V2\Tests\Mock\NoArgTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\OneTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\Success;
+use Zynga\PHPUnit\V2\Tests\Mock\TimedTestPlan;
+
+class SchedulerTest extends TestCase {
+
+  private function createTests(): Vector<TestInterface> {
+    return TimedTestPlan::createTests(2);
+  }
+
+  private function createGroups(): Vector<Vector<int>> {
+    return Vector {Vector {0}, Vector {1, 2}, Vector {3}, Vector {4}};
+  }
+
+  private function createTimings(): TimingDatabase {
+    return TimedTestPlan::createTimings(
+      Map {
+        Success::class => 5.0,
+        OneTestCase::class => 2.0,
+        NoArgTestCase::class => 3.0,
+      },
+    );
+  }
+
+  public function testEstimateUsesRecordedTimes(): void {
+
+    $scheduler = new Scheduler(2, $this->createTimings());
+
+    $tests = $this->createTests();
+    $groups = $this->createGroups();
+
+    $this->assertEquals(5.0, $scheduler->estimate($tests, $groups[0]));
+    $this->assertEquals(4.0, $scheduler->estimate($tests, $groups[1]));
+    $this->assertNull($scheduler->estimate($tests, $groups[3]));
+
+  }
+
+  public function testKnownGroupsAreBalancedLongestFirst(): void {
+
+    $scheduler = new Scheduler(2, $this->createTimings());
+
+    list($shares, $stealOrder) =
+      $scheduler->schedule($this->createTests(), $this->createGroups());
+
+    // 5.0 alone on one worker, 4.0 + 3.0 on the other, in plan order.
+    $this->assertEquals(2, $shares->count());
+    $this->assertEquals(Vector {0}, $shares[0]);
+    $this->assertEquals(Vector {1, 2}, $shares[1]);
+
+    // the untimed class is only ever stolen, assumed to take the mean of
+    // 3.33 it goes ahead of the 3.0 group.
+    $this->assertEquals(Vector {0, 1, 3, 2}, $stealOrder);
+
+  }
+
+  public function testWithoutHistoryEverythingIsStolenInPlanOrder(): void {
+
+    $scheduler = new Scheduler(3, null);
+
+    list($shares, $stealOrder) =
+      $scheduler->schedule($this->createTests(), $this->createGroups());
+
+    $this->assertEquals(3, $shares->count());
+
+    foreach ($shares as $share) {
+      $this->assertEquals(0, $share->count());
+    }
+
+    $this->assertEquals(Vector {0, 1, 2, 3}, $stealOrder);
+
+  }
+
+}
@@ -0,0 +1,177 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\PHPUnit\V2\Interfaces\TestInterface;
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestSuite\Sharding;
+use Zynga\PHPUnit\V2\Tests\Mock\InheritedTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\NoArgTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\OneTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\Success;
+use Zynga\PHPUnit\V2\Tests\Mock\TimedTestPlan;
+use Zynga\PHPUnit\V2\Tests\Mock\WasRun;
+
+class ShardingTest extends TestCase {
+
+  private function createTests(): Vector<TestInterface> {
+    return TimedTestPlan::createTests(3);
+  }
+
+  public function testParseShard(): void {
+    $this->assertEquals(tuple(2, 3), Sharding::parseShard('2/3'));
+    $this->assertEquals(tuple(1, 1), Sharding::parseShard(' 1 / 1 '));
+    $this->assertNull(Sharding::parseShard('0/3'));
+    $this->assertNull(Sharding::parseShard('4/3'));
+    $this->assertNull(Sharding::parseShard('1/0'));
+    $this->assertNull(Sharding::parseShard('one/two'));
+  }
+
+  public function testWithoutTimingsClassesWeighTheirTestCount(): void {
+
+    $sharding = new Sharding(2, null);
+
+    $shards = $sharding->partition($this->createTests());
+
+    // OneTestCase (3) alone, the single test classes fill the other shard.
+    $this->assertEquals(Vector {OneTestCase::class}, $shards[0]);
+    $this->assertEquals(
+      Vector {Success::class, NoArgTestCase::class, WasRun::class},
+      $shards[1],
+    );
+
+  }
+
+  public function testTimingsDecideThePartition(): void {
+
+    $timings = TimedTestPlan::createTimings(
+      Map {
+        Success::class => 9.0,
+        OneTestCase::class => 1.0,
+        NoArgTestCase::class => 2.0,
+        WasRun::class => 3.0,
+      },
+    );
+
+    $sharding = new Sharding(2, $timings);
+
+    $shards = $sharding->partition($this->createTests());
+
+    $this->assertEquals(Vector {Success::class}, $shards[0]);
+    $this->assertEquals(
+      Vector {OneTestCase::class, NoArgTestCase::class, WasRun::class},
+      $shards[1],
+    );
+
+  }
+
+  public function testPartitionIsDeterministic(): void {
+
+    $sharding = new Sharding(3, null);
+
+    $this->assertEquals(
+      $sharding->partition($this->createTests()),
+      $sharding->partition($this->createTests()),
+    );
+
+  }
+
+  // --
+  // Every class of the plan on exactly one shard.
+  // --
+  private function assertShardsCoverThePlan(
+    Vector<TestInterface> $tests,
+    Vector<Vector<string>> $shards,
+  ): void {
+
+    $planClasses = Map {};
+    foreach ($tests as $test) {
+      $planClasses->set(get_class($test), true);
+    }
+
+    $shardClasses = Map {};
+    foreach ($shards as $classNames) {
+      foreach ($classNames as $className) {
+        $this->assertFalse($shardClasses->containsKey($className));
+        $shardClasses->set($className, true);
+      }
+    }
+
+    $planKeys = $planClasses->keys()->toArray();
+    $shardKeys = $shardClasses->keys()->toArray();
+    sort($planKeys);
+    sort($shardKeys);
+
+    $this->assertEquals($planKeys, $shardKeys);
+
+  }
+
+  public function testShardsAreDisjointAndCoverThePlan(): void {
+
+    $tests = $this->createTests();
+    $timings = TimedTestPlan::createTimings(
+      Map {Success::class => 4.0, WasRun::class => 0.5},
+    );
+
+    for ($shardCount = 1; $shardCount <= 6; $shardCount++) {
+      foreach (array(null, $timings) as $shardTimings) {
+        $sharding = new Sharding($shardCount, $shardTimings);
+        $shards = $sharding->partition($tests);
+        $this->assertEquals($shardCount, $shards->count());
+        $this->assertShardsCoverThePlan($tests, $shards);
+      }
+    }
+
+  }
+
+  public function testManifestDecidesTheSplitOnEveryMachine(): void {
+
+    $manifestFile = tempnam(sys_get_temp_dir(), 'shard-manifest-');
+    @unlink($manifestFile);
+
+    $tests = $this->createTests();
+
+    // the machine writing the manifest has timings the others lack.
+    $writer = new Sharding(
+      2,
+      TimedTestPlan::createTimings(Map {Success::class => 9.0}),
+    );
+    $shards = $writer->partition($tests);
+
+    $this->assertTrue($writer->writeManifest($manifestFile, $tests, $shards));
+
+    $reader = new Sharding(2, null);
+    $this->assertNotEquals($shards, $reader->partition($tests));
+
+    $manifestShards = $reader->readManifest($manifestFile);
+
+    $this->assertEquals($shards, $manifestShards);
+
+    if ($manifestShards !== null) {
+
+      $this->assertEquals(
+        $shards,
+        $reader->partitionFromManifest($tests, $manifestShards),
+      );
+
+      // a class added since still lands on one shard only.
+      $grown = $this->createTests();
+      $grown->add(new InheritedTestCase('test2'));
+
+      $this->assertShardsCoverThePlan(
+        $grown,
+        $reader->partitionFromManifest($grown, $manifestShards),
+      );
+
+    }
+
+    // written for another shard count, it cannot be followed.
+    $this->assertNull((new Sharding(3, null))->readManifest($manifestFile));
+
+    @unlink($manifestFile);
+
+    $this->assertNull($reader->readManifest($manifestFile));
+
+  }
+
+}
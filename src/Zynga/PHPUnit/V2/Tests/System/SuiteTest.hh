@@ -13,11 +13,13 @@ namespace Zynga\PHPUnit\V2\Tests\System;
 use Zynga\PHPUnit\V2\TestCase\Status;
 use Zynga\PHPUnit\V2\TestResult;
 use Zynga\PHPUnit\V2\TestSuite;
+use Zynga\PHPUnit\V2\TestSuite\TimingDatabase;
 use Zynga\PHPUnit\V2\Tests\System\BaseTest;
 use Zynga\PHPUnit\V2\Tests\Mock\BeforeAndAfterTest;
 use Zynga\PHPUnit\V2\Tests\Mock\BeforeClassAndAfterClassTest;
 use Zynga\PHPUnit\V2\Tests\Mock\BeforeClassWithOnlyDataProviderTest;
 use Zynga\PHPUnit\V2\Tests\Mock\DataProviderIncompleteTest;
+use Zynga\PHPUnit\V2\Tests\Mock\GeneratorDataProviderTest;
 use Zynga\PHPUnit\V2\Tests\Mock\InheritedTestCase;
 use Zynga\PHPUnit\V2\Tests\Mock\OneTestCase;
 use Zynga\PHPUnit\V2\Tests\Mock\NoTestCases;
@@ -351,6 +353,67 @@ class SuiteTest extends BaseTest {
 
   }
 
+  public function testDataProviderRunsWithItsTest(): void {
+
+    GeneratorDataProviderTest::resetProperties();
+
+    $suite = new TestSuite(GeneratorDataProviderTest::class);
+
+    // building the suite leaves the provider alone.
+    $this->assertEquals(0, GeneratorDataProviderTest::$providerCalls);
+    $this->assertEquals(1, $suite->count());
+
+    $result = $suite->run();
+
+    $this->assertEquals(1, GeneratorDataProviderTest::$providerCalls);
+
+    $this->_verifyTestSuite(
+      $suite,
+      $result,
+      false, // debug
+      Status::STATUS_PASSED, // status
+      3, // testCount
+      2, // successful
+      0, // error
+      0, // failure
+      0, // skipped
+      1, // incomplete
+      0, // warning
+      1, // notImplemented
+    );
+
+  }
+
+  public function testArrayDataProviderCountMatchesEagerExpansion(): void {
+
+    $eager = new TestSuite(DataProviderIncompleteTest::class);
+    $eager->expandLazyDataProviders();
+
+    $expectedCount = $eager->count();
+
+    $timings = new TimingDatabase('/nonexistent/timings.db');
+
+    $result = new TestResult();
+    $result->setTimingDatabase($timings);
+
+    $suite = new TestSuite(DataProviderIncompleteTest::class);
+
+    // every stand-in counts as one until its provider is known.
+    $this->assertEquals($suite->getPlan()->getTestCount(), $suite->count());
+
+    $suite->run($result);
+
+    $this->assertEquals($expectedCount, $suite->count());
+    $this->assertEquals($expectedCount, $result->count());
+
+    // the next run counts the data sets before calling the providers.
+    $nextSuite = new TestSuite(DataProviderIncompleteTest::class);
+    $nextSuite->setExpectedDataSetCounts($timings);
+
+    $this->assertEquals($expectedCount, $nextSuite->count());
+
+  }
+
   public function testRequirementsBeforeClassHook(): void {
 
     $suite = new TestSuite(RequirementsClassBeforeClassHookTest::class);
@@ -35,6 +35,7 @@ use Zynga\PHPUnit\V2\Tests\Mock\NoArgTestCase;
 use Zynga\PHPUnit\V2\Tests\Mock\OutputTestCase;
 use Zynga\PHPUnit\V2\Tests\Mock\Requirements;
 use Zynga\PHPUnit\V2\Tests\Mock\Singleton;
+use Zynga\PHPUnit\V2\Tests\Mock\SlowTestCase;
 use Zynga\PHPUnit\V2\Tests\Mock\Success;
 use Zynga\PHPUnit\V2\Tests\Mock\TestError;
 use Zynga\PHPUnit\V2\Tests\Mock\TestIncomplete;
@@ -1096,6 +1097,21 @@ class TestCaseTest extends BaseTest {
     $this->assertSame($expectedCwd, getcwd());
   }
 
+  public function testTimeLimitAbortsSlowTest(): void {
+
+    $result = new TestResult();
+    $result->enforceTimeLimit(true);
+    $result->setTimeoutForSmallTests(1);
+
+    $test = new SlowTestCase('testSleep');
+    $test->run($result);
+
+    $this->assertEquals(1, $result->riskyCount());
+    $this->assertEquals(Status::STATUS_RISKY, $test->status()->getCode());
+    $this->assertLessThan(5.0, $test->getBareElapsed());
+
+  }
+
   public function testExpectedExceptionInComments(): void {
 
     $test = new ExceptionInButExpected('testSomething');
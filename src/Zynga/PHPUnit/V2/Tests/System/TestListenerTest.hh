@@ -18,6 +18,7 @@ use Zynga\PHPUnit\V2\Tests\Mock\Failure;
 use Zynga\PHPUnit\V2\Tests\Mock\Success;
 use Zynga\PHPUnit\V2\Tests\Mock\TestError;
 use Zynga\PHPUnit\V2\TestResult;
+use Zynga\PHPUnit\V2\TestResult\TestProfile;
 
 use \Exception;
 
@@ -27,6 +28,7 @@ use \Exception;
  */
 class TestListenerTest extends TestCase implements TestListenerInterface {
   protected int $endCount = 0;
+  protected int $profileCount = 0;
   protected int $errorCount = 0;
   protected int $failureCount = 0;
   protected int $warningCount = 0;
@@ -92,6 +94,13 @@ class TestListenerTest extends TestCase implements TestListenerInterface {
     $this->startCount++;
   }
 
+  public function addTestProfile(
+    TestInterface $test,
+    TestProfile $profile,
+  ): void {
+    $this->profileCount++;
+  }
+
   public function endTest(TestInterface $test, float $time): void {
     $this->endCount++;
   }
@@ -104,6 +113,7 @@ class TestListenerTest extends TestCase implements TestListenerInterface {
     $this->result = $result;
 
     $this->endCount = 0;
+    $this->profileCount = 0;
     $this->failureCount = 0;
     $this->notImplementedCount = 0;
     $this->riskyCount = 0;
@@ -136,6 +146,23 @@ class TestListenerTest extends TestCase implements TestListenerInterface {
     $this->assertEquals(1, $this->endCount);
   }
 
+  public function testProfileReportedBeforeEnd(): void {
+    $test = new Success('testNoop');
+    $test->run($this->result);
+
+    $this->assertEquals(1, $this->profileCount);
+
+    $profile = $test->getProfile();
+
+    $this->assertNotNull($profile);
+
+    if ($profile instanceof TestProfile) {
+      $this->assertEquals(0, $profile->getAssertions());
+      $this->assertGreaterThanOrEqual(0.0, $profile->getWallTime());
+      $this->assertGreaterThan(0, $profile->getPeakMemory());
+    }
+  }
+
   public function flush(): void {}
 
 }
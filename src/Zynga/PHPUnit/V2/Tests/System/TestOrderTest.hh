@@ -0,0 +1,152 @@
+<?hh // strict
+
+namespace Zynga\PHPUnit\V2\Tests\System;
+
+use Zynga\PHPUnit\V2\TestCase;
+use Zynga\PHPUnit\V2\TestSuite;
+use Zynga\PHPUnit\V2\TestSuite\ResultCache;
+use Zynga\PHPUnit\V2\TestSuite\TestOrder;
+use Zynga\PHPUnit\V2\Tests\Mock\GeneratorDataProviderTest;
+use Zynga\PHPUnit\V2\Tests\Mock\NoArgTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\OneTestCase;
+use Zynga\PHPUnit\V2\Tests\Mock\Success;
+use Zynga\PHPUnit\V2\Tests\Mock\TimedTestPlan;
+use Zynga\PHPUnit\V2\Tests\Mock\WasRun;
+
+class TestOrderTest extends TestCase {
+
+  private function createSuite(): TestSuite {
+    $suite = new TestSuite();
+    $suite->setTests(TimedTestPlan::createTests(2));
+    return $suite;
+  }
+
+  private function getClassOrder(TestSuite $suite): Vector<string> {
+    $classes = Vector {};
+    foreach ($suite->getPlan()->getTests() as $test) {
+      $classes->add(get_class($test));
+    }
+    return $classes;
+  }
+
+  public function testParseOrder(): void {
+    $this->assertEquals(
+      ImmVector {TestOrder::ORDER_DEFECTS, TestOrder::ORDER_FASTEST},
+      TestOrder::parseOrder('defects, fastest'),
+    );
+    $this->assertNull(TestOrder::parseOrder('defects,random'));
+  }
+
+  public function testDefectsRunFirstAndClassesStayTogether(): void {
+
+    $resultCache = new ResultCache('/nonexistent/results.cache');
+    $resultCache->record(
+      WasRun::class,
+      'testWasRun',
+      ResultCache::OUTCOME_DEFECT,
+    );
+    $resultCache->record(
+      Success::class,
+      'testNoop',
+      ResultCache::OUTCOME_PASSED,
+    );
+
+    $suite = $this->createSuite();
+
+    $order = new TestOrder(
+      ImmVector {TestOrder::ORDER_DEFECTS},
+      $resultCache,
+      null,
+    );
+    $order->reorder($suite);
+
+    $this->assertEquals(
+      Vector {
+        WasRun::class,
+        Success::class,
+        OneTestCase::class,
+        OneTestCase::class,
+        NoArgTestCase::class,
+      },
+      $this->getClassOrder($suite),
+    );
+
+  }
+
+  public function testFastestFirstBreaksTiesOfDefects(): void {
+
+    $resultCache = new ResultCache('/nonexistent/results.cache');
+    $resultCache->record(
+      OneTestCase::class,
+      'testCase',
+      ResultCache::OUTCOME_DEFECT,
+    );
+    $resultCache->record(
+      Success::class,
+      'testNoop',
+      ResultCache::OUTCOME_DEFECT,
+    );
+
+    $timings = TimedTestPlan::createTimings(
+      Map {
+        Success::class => 5.0,
+        OneTestCase::class => 1.0,
+        NoArgTestCase::class => 3.0,
+        WasRun::class => 0.5,
+      },
+    );
+
+    $suite = $this->createSuite();
+
+    $order = new TestOrder(
+      ImmVector {TestOrder::ORDER_DEFECTS, TestOrder::ORDER_FASTEST},
+      $resultCache,
+      $timings,
+    );
+    $order->reorder($suite);
+
+    // OneTestCase takes 2.0 for its two tests, still less than Success.
+    $this->assertEquals(
+      Vector {
+        OneTestCase::class,
+        OneTestCase::class,
+        Success::class,
+        WasRun::class,
+        NoArgTestCase::class,
+      },
+      $this->getClassOrder($suite),
+    );
+
+  }
+
+  public function testFastestCountsEveryDataSetOfADeferredProvider(): void {
+
+    $timings = TimedTestPlan::createTimings(Map {Success::class => 5.0});
+    $timings->record(GeneratorDataProviderTest::class, 'testAdd', 2.0);
+    $timings->recordDataSetCount(GeneratorDataProviderTest::class, 'testAdd', 3);
+
+    $suite = new TestSuite();
+    $suite->setTests(
+      Vector {
+        new TestSuite(GeneratorDataProviderTest::class),
+        new Success('testNoop'),
+      },
+    );
+    $suite->setExpectedDataSetCounts($timings);
+
+    $order = new TestOrder(
+      ImmVector {TestOrder::ORDER_FASTEST},
+      null,
+      $timings,
+    );
+    $order->reorder($suite);
+
+    // three data sets of 2.0 each take longer than Success.
+    $this->assertEquals(
+      Vector {Success::class, GeneratorDataProviderTest::class},
+      $this->getClassOrder($suite),
+    );
+
+  }
+
+}
@@ -0,0 +1,169 @@
+<?hh
+
+// --
+// Micro-benchmark for Stream\BlockIndex.
+//
+// Compares the forward scans the tokens used to run to find the end of their
+// blocks against the precomputed index built by the scanner, and verifies
+// both give the same answer for every token.
+//
+// usage: hhvm tests/performance/block-index.hh [file ...]
+//
+// With no files given the token-stream fixtures plus the largest sources
+// within this repo are used.
+// --
+
+$projectRoot = dirname(dirname(dirname(__FILE__)));
+
+require_once $projectRoot.'/vendor/autoload.php';
+
+use SebastianBergmann\TokenStream\TokenInterface;
+use SebastianBergmann\TokenStream\TokenWithScope;
+use SebastianBergmann\TokenStream\Token\Stream;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Close_Curly;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Curly_Open;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Function;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Namespace;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Open_Curly;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Semicolon;
+use Zynga\CodeBase\V1\File;
+
+function legacyEndTokenId(Stream $stream, TokenInterface $scopeToken): int {
+
+  $block = 0;
+  $tokens = $stream->tokens();
+  $tokenCount = $tokens->count();
+
+  for ($i = $scopeToken->getId(); $i < $tokenCount; $i++) {
+
+    $token = $tokens->get($i);
+
+    if ($token === null) {
+      break;
+    }
+
+    if ($token instanceof PHP_Token_Open_Curly ||
+        $token instanceof PHP_Token_Curly_Open) {
+      $block++;
+    } else if ($token instanceof PHP_Token_Close_Curly) {
+      $block--;
+      if ($block === 0) {
+        return $token->getId();
+      }
+    } else if (($scopeToken instanceof PHP_Token_Function ||
+                $scopeToken instanceof PHP_Token_Namespace) &&
+               $token instanceof PHP_Token_Semicolon) {
+      if ($block === 0) {
+        return $token->getId();
+      }
+    }
+
+  }
+
+  return $scopeToken->getId();
+
+}
+
+function indexedEndTokenId(Stream $stream, TokenInterface $scopeToken): int {
+
+  $blockIndex = $stream->blockIndex();
+
+  $endTokenId = $blockIndex->getEndOfBlockId($scopeToken->getId());
+
+  if ($scopeToken instanceof PHP_Token_Function ||
+      $scopeToken instanceof PHP_Token_Namespace) {
+    $endOfStatementId = $blockIndex->getEndOfStatementId($scopeToken->getId());
+    if ($endOfStatementId !== -1 &&
+        ($endTokenId === -1 || $endOfStatementId < $endTokenId)) {
+      $endTokenId = $endOfStatementId;
+    }
+  }
+
+  if ($endTokenId === -1) {
+    return $scopeToken->getId();
+  }
+
+  return $endTokenId;
+
+}
+
+$files = array();
+
+for ($i = 1; $i < count($argv); $i++) {
+  $files[] = realpath($argv[$i]);
+}
+
+if (count($files) == 0) {
+  $files = glob($projectRoot.'/tests/token-stream/_fixture/*');
+  $files[] = $projectRoot.'/src/SebastianBergmann/TokenStream/Token/Factory.hh';
+  $files[] = $projectRoot.'/src/PHPUnit/TextUI/Command.php';
+  $files[] = $projectRoot.'/src/PHPUnit/Util/Configuration.php';
+  $files[] = $projectRoot.'/src/Zynga/CodeBase/V1/File.hh';
+}
+
+$iterations = 5;
+$totalLegacy = 0.0;
+$totalIndexed = 0.0;
+$mismatches = 0;
+
+foreach ($files as $fileName) {
+
+  $codeFile = new File($fileName);
+  $stream = $codeFile->stream();
+
+  $scopeTokens = Vector {};
+  foreach ($stream->tokens() as $token) {
+    if ($token instanceof TokenWithScope) {
+      $scopeTokens->add($token);
+    }
+  }
+
+  $legacyResults = Vector {};
+  $start = microtime(true);
+  for ($n = 0; $n < $iterations; $n++) {
+    $legacyResults->clear();
+    foreach ($scopeTokens as $token) {
+      $legacyResults->add(legacyEndTokenId($stream, $token));
+    }
+  }
+  $legacyTime = microtime(true) - $start;
+
+  $indexedResults = Vector {};
+  $start = microtime(true);
+  for ($n = 0; $n < $iterations; $n++) {
+    $indexedResults->clear();
+    foreach ($scopeTokens as $token) {
+      $indexedResults->add(indexedEndTokenId($stream, $token));
+    }
+  }
+  $indexedTime = microtime(true) - $start;
+
+  foreach ($legacyResults as $offset => $legacyId) {
+    if ($indexedResults->get($offset) !== $legacyId) {
+      $mismatches++;
+    }
+  }
+
+  $totalLegacy += $legacyTime;
+  $totalIndexed += $indexedTime;
+
+  printf(
+    "%-60s tokens=%6d scopes=%5d legacy=%8.4fs indexed=%8.4fs\n",
+    substr(str_replace($projectRoot.'/', '', $fileName), -60),
+    $stream->count(),
+    $scopeTokens->count(),
+    $legacyTime,
+    $indexedTime,
+  );
+
+}
+
+printf(
+  "total legacy=%.4fs indexed=%.4fs speedup=%.1fx mismatches=%d\n",
+  $totalLegacy,
+  $totalIndexed,
+  $totalIndexed > 0 ? $totalLegacy / $totalIndexed : 0,
+  $mismatches,
+);
+
+exit($mismatches == 0 ? 0 : 1);
@@ -0,0 +1,159 @@
+<?hh
+
+// --
+// Micro-benchmark for Driver\HHVM::stop().
+//
+// Feeds the same synthetic xdebug coverage data, one array per test, through
+// the line by line processing stop() used to do and through the batched
+// Driver\HHVM::process(), then checks both leave every file with the same
+// line states.
+//
+// usage: hhvm tests/performance/hhvm-driver-stop.hh [tests] [file ...]
+//
+// With no files given the token-stream fixtures plus the largest sources
+// within this repo are used, 200 tests are simulated by default.
+// --
+
+$projectRoot = dirname(dirname(dirname(__FILE__)));
+
+require_once $projectRoot.'/vendor/autoload.php';
+
+use SebastianBergmann\CodeCoverage\Driver;
+use SebastianBergmann\CodeCoverage\Driver\HHVM;
+use Zynga\CodeBase\V1\FileFactory;
+
+function legacyStop(string $testId, array<string, array<int, int>> $data): void {
+
+  foreach ($data as $fileName => $execStatuses) {
+
+    if (FileFactory::isFileRegistered($fileName) === false) {
+      continue;
+    }
+
+    $processedFile = FileFactory::get($fileName);
+
+    foreach ($execStatuses as $lineNo => $lineState) {
+      $processedFile->setLineToTest($lineNo, $testId);
+      if ($lineState >= Driver::LINE_EXECUTED) {
+        $processedFile->lineExecutionState()
+          ->set($lineNo, Driver::LINE_EXECUTED);
+        if ($processedFile->lineExecutionState()
+              ->isLineWithinExecutableRange($lineNo) === true) {
+          $executableRanges =
+            $processedFile->lineExecutionState()->getExecutableRanges($lineNo);
+          foreach ($executableRanges as $executableRange) {
+            for ($innerRange = $executableRange->getStart();
+                 $innerRange <= $executableRange->getEnd();
+                 $innerRange++) {
+              $processedFile->lineExecutionState()
+                ->set($innerRange, Driver::LINE_EXECUTED);
+            }
+          }
+        }
+      } else {
+        $processedFile->lineExecutionState()->set($lineNo, $lineState);
+      }
+    }
+
+  }
+
+}
+
+function loadFiles(array<string> $files): void {
+  FileFactory::clear();
+  foreach ($files as $fileName) {
+    FileFactory::get($fileName);
+  }
+}
+
+function snapshot(array<string> $files): array<string, array<int, int>> {
+  $states = array();
+  foreach ($files as $fileName) {
+    $states[$fileName] =
+      FileFactory::get($fileName)->lineExecutionState()->getAll()->toArray();
+  }
+  return $states;
+}
+
+$testCount = 200;
+$files = array();
+
+for ($i = 1; $i < count($argv); $i++) {
+  if ($i == 1 && is_numeric($argv[$i])) {
+    $testCount = intval($argv[$i]);
+    continue;
+  }
+  $files[] = realpath($argv[$i]);
+}
+
+if (count($files) == 0) {
+  $files = glob($projectRoot.'/tests/token-stream/_fixture/*');
+  $files[] = $projectRoot.'/src/SebastianBergmann/TokenStream/Token/Factory.hh';
+  $files[] = $projectRoot.'/src/PHPUnit/TextUI/Command.php';
+  $files[] = $projectRoot.'/src/PHPUnit/Util/Configuration.php';
+  $files[] = $projectRoot.'/src/Zynga/CodeBase/V1/File.hh';
+}
+
+loadFiles($files);
+
+// every test executes a random share of the lines init() found executable.
+mt_srand(42);
+
+$coverage = array();
+
+for ($n = 0; $n < $testCount; $n++) {
+  $data = array();
+  foreach ($files as $fileName) {
+    $lines = array();
+    $lineStates = FileFactory::get($fileName)->lineExecutionState()->getAll();
+    foreach ($lineStates as $lineNo => $lineState) {
+      if ($lineState === Driver::LINE_NOT_EXECUTED) {
+        $lines[$lineNo] =
+          mt_rand(0, 99) < 30 ? Driver::LINE_EXECUTED : Driver::LINE_NOT_EXECUTED;
+      }
+    }
+    $data[$fileName] = $lines;
+  }
+  $coverage['BenchmarkTest::test'.$n] = $data;
+}
+
+$start = microtime(true);
+foreach ($coverage as $testId => $data) {
+  legacyStop($testId, $data);
+}
+$legacyTime = microtime(true) - $start;
+$legacyStates = snapshot($files);
+
+loadFiles($files);
+
+// the driver refuses to construct without xdebug, which stop() needs but
+// process() does not.
+$reflection = new ReflectionClass(HHVM::class);
+$driver = $reflection->newInstanceWithoutConstructor();
+
+$start = microtime(true);
+foreach ($coverage as $testId => $data) {
+  $driver->process($testId, $data);
+}
+$batchedTime = microtime(true) - $start;
+$batchedStates = snapshot($files);
+
+$mismatches = 0;
+foreach ($legacyStates as $fileName => $states) {
+  if ($batchedStates[$fileName] !== $states) {
+    $mismatches++;
+    echo "mismatch file=$fileName\n";
+  }
+}
+
+printf(
+  "files=%d tests=%d legacy=%.3fms/test batched=%.3fms/test speedup=%.1fx mismatches=%d\n",
+  count($files),
+  $testCount,
+  $legacyTime / $testCount * 1000,
+  $batchedTime / $testCount * 1000,
+  $batchedTime > 0 ? $legacyTime / $batchedTime : 0,
+  $mismatches,
+);
+
+exit($mismatches == 0 ? 0 : 1);
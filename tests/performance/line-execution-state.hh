@@ -0,0 +1,149 @@
+<?hh
+
+// --
+// Memory comparison for File\LineExecutionState.
+//
+// Analyzes each file, then rebuilds its line states and executable ranges
+// both the way LineExecutionState used to hold them (a Map of line states and
+// every range registered against each line it spans) and with the packed
+// storage, reporting the memory each one holds and checking both answer the
+// same for every line.
+//
+// usage: hhvm tests/performance/line-execution-state.hh [file ...]
+//
+// With no files given the token-stream fixtures plus the largest sources
+// within this repo are used.
+// --
+
+$projectRoot = dirname(dirname(dirname(__FILE__)));
+
+require_once $projectRoot.'/vendor/autoload.php';
+
+use Zynga\CodeBase\V1\File;
+use Zynga\CodeBase\V1\File\ExecutableRange;
+use Zynga\CodeBase\V1\File\LineExecutionState;
+
+function buildLegacy(
+  LineExecutionState $source,
+): (Map<int, int>, Map<int, Vector<ExecutableRange>>) {
+
+  $states = Map {};
+  foreach ($source->getAll() as $lineNo => $lineState) {
+    $states->set($lineNo, $lineState);
+  }
+
+  $ranges = Map {};
+  foreach ($source->getExecutableRangeIntervals() as $interval) {
+    list($firstLine, $lastLine, $range) = $interval;
+    for ($lineNo = $firstLine; $lineNo <= $lastLine; $lineNo++) {
+      $lineRanges = $ranges->get($lineNo);
+      if (!$lineRanges instanceof Vector) {
+        $lineRanges = Vector {};
+        $ranges->set($lineNo, $lineRanges);
+      }
+      $lineRanges->add($range);
+    }
+  }
+
+  return tuple($states, $ranges);
+
+}
+
+function buildPacked(File $file, LineExecutionState $source): LineExecutionState {
+
+  $packed = new LineExecutionState($file);
+
+  foreach ($source->getAll() as $lineNo => $lineState) {
+    $packed->set($lineNo, $lineState);
+  }
+
+  foreach ($source->getExecutableRangeIntervals() as $interval) {
+    list($firstLine, $lastLine, $range) = $interval;
+    $packed->addRangeToLines($firstLine, $lastLine, $range);
+  }
+
+  return $packed;
+
+}
+
+$files = array();
+
+for ($i = 1; $i < count($argv); $i++) {
+  $files[] = realpath($argv[$i]);
+}
+
+if (count($files) == 0) {
+  $files = glob($projectRoot.'/tests/token-stream/_fixture/*');
+  $files[] = $projectRoot.'/src/SebastianBergmann/TokenStream/Token/Factory.hh';
+  $files[] = $projectRoot.'/src/PHPUnit/TextUI/Command.php';
+  $files[] = $projectRoot.'/src/PHPUnit/Util/Configuration.php';
+  $files[] = $projectRoot.'/src/Zynga/CodeBase/V1/File.hh';
+}
+
+$totalLegacy = 0;
+$totalPacked = 0;
+$mismatches = 0;
+
+foreach ($files as $fileName) {
+
+  $codeFile = new File($fileName);
+  $codeFile->init();
+
+  $source = $codeFile->lineExecutionState();
+
+  $before = memory_get_usage();
+  $legacy = buildLegacy($source);
+  $legacyBytes = memory_get_usage() - $before;
+
+  $before = memory_get_usage();
+  $packed = buildPacked($codeFile, $source);
+  $packedBytes = memory_get_usage() - $before;
+
+  list($legacyStates, $legacyRanges) = $legacy;
+
+  for ($lineNo = 0; $lineNo <= $codeFile->getEndLine(); $lineNo++) {
+    if ($legacyStates->get($lineNo) !== $packed->get($lineNo)) {
+      $mismatches++;
+    }
+    $expected = $legacyRanges->get($lineNo);
+    $actual = $packed->getExecutableRanges($lineNo);
+    if ($expected === null) {
+      if ($actual->count() != 0 ||
+          $packed->isLineWithinExecutableRange($lineNo) === true) {
+        $mismatches++;
+      }
+      continue;
+    }
+    if ($expected->count() != $actual->count()) {
+      $mismatches++;
+      continue;
+    }
+    foreach ($expected as $offset => $range) {
+      if ($actual[$offset] !== $range) {
+        $mismatches++;
+      }
+    }
+  }
+
+  $totalLegacy += $legacyBytes;
+  $totalPacked += $packedBytes;
+
+  printf(
+    "%-60s lines=%6d legacy=%9d bytes packed=%9d bytes\n",
+    substr(str_replace($projectRoot.'/', '', $fileName), -60),
+    $codeFile->getEndLine(),
+    $legacyBytes,
+    $packedBytes,
+  );
+
+}
+
+printf(
+  "total legacy=%d bytes packed=%d bytes saved=%.1f%% mismatches=%d\n",
+  $totalLegacy,
+  $totalPacked,
+  $totalLegacy > 0 ? (1 - $totalPacked / $totalLegacy) * 100 : 0,
+  $mismatches,
+);
+
+exit($mismatches == 0 ? 0 : 1);
@@ -0,0 +1,166 @@
+<?hh
+
+// --
+// Benchmark for Node\Builder over a synthetic directory tree.
+//
+// Builds the report tree for a set of made up file paths both the way the
+// builder used to link directories (every directory checked against every
+// other one) and with the single pass that attaches each directory to its
+// parent as it is created, and checks both give the same tree.
+//
+// usage: hhvm tests/performance/node-builder.hh [directories]
+//
+// Defaults to 10000 leaf directories spread over 100 packages of 10 modules.
+// The paths do not exist on disk, so only directories end up in the tree.
+// --
+
+$projectRoot = dirname(dirname(dirname(__FILE__)));
+
+require_once $projectRoot.'/vendor/autoload.php';
+
+use SebastianBergmann\CodeCoverage\Node\Builder;
+use SebastianBergmann\CodeCoverage\Node\Directory;
+
+function legacyIsChildOfDirectory(
+  string $directory,
+  string $childDirectory,
+): bool {
+
+  if ($directory == $childDirectory) {
+    return false;
+  }
+
+  $offset = strpos($childDirectory, $directory);
+
+  if ($offset !== false && $offset == 0) {
+    if (dirname($childDirectory) == $directory) {
+      return true;
+    }
+  }
+
+  return false;
+
+}
+
+function legacyBuildTree(Vector<string> $fileNames): Directory {
+
+  $dirMap = Map {};
+
+  $root = new Directory(DIRECTORY_SEPARATOR);
+
+  $dirMap->set(DIRECTORY_SEPARATOR, $root);
+
+  foreach ($fileNames as $fileName) {
+
+    $directory = dirname($fileName);
+
+    $directoryEntry = $dirMap->get($directory);
+
+    if ($directoryEntry instanceof Directory) {
+      $directoryEntry->addFileFullPath($fileName);
+      continue;
+    }
+
+    $directoryEntry = new Directory($directory);
+    $directoryEntry->addFileFullPath($fileName);
+    $dirMap->set($directory, $directoryEntry);
+
+    $t_directory = $directory;
+    while ($t_directory != DIRECTORY_SEPARATOR) {
+      $t_directory = dirname($t_directory);
+      if (!$dirMap->get($t_directory) instanceof Directory) {
+        $dirMap->set($t_directory, new Directory($t_directory));
+      }
+    }
+
+  }
+
+  foreach ($dirMap as $directory => $directoryEntry) {
+    foreach ($dirMap as $childDirectory => $childDirectoryEntry) {
+      if (legacyIsChildOfDirectory($directory, $childDirectory) === true) {
+        $directoryEntry->addAlreadyCreatedDirectory($childDirectoryEntry);
+      }
+    }
+  }
+
+  return $root;
+
+}
+
+function describeTree(Directory $node, Vector<string> $lines): int {
+
+  $children = Vector {};
+
+  foreach ($node->getDirectories() as $child) {
+    $children->add($child->getName());
+  }
+
+  $lines->add($node->getName().' => '.implode(',', $children));
+
+  $count = 1;
+
+  foreach ($node->getDirectories() as $child) {
+    $count += describeTree($child, $lines);
+  }
+
+  return $count;
+
+}
+
+$leafCount = 10000;
+
+if (count($argv) > 1) {
+  $leafCount = intval($argv[1]);
+}
+
+$fileNames = Vector {};
+
+for ($i = 0; $i < $leafCount; $i++) {
+  $fileNames->add(
+    sprintf(
+      '/synthetic/package%d/module%d/leaf%d/Source.hh',
+      $i % 100,
+      intval($i / 100) % 10,
+      $i,
+    ),
+  );
+}
+
+$start = microtime(true);
+$legacyRoot = legacyBuildTree($fileNames);
+$legacyTime = microtime(true) - $start;
+
+$builder = new Builder();
+
+$start = microtime(true);
+$root = $builder->buildTree($fileNames);
+$builderTime = microtime(true) - $start;
+
+$legacyLines = Vector {};
+$directoryCount = describeTree($legacyRoot, $legacyLines);
+
+$lines = Vector {};
+describeTree($root, $lines);
+
+$mismatches = 0;
+
+if ($legacyLines->count() != $lines->count()) {
+  $mismatches++;
+} else {
+  foreach ($legacyLines as $offset => $line) {
+    if ($lines[$offset] !== $line) {
+      $mismatches++;
+    }
+  }
+}
+
+printf(
+  "directories=%d legacy=%.4fs builder=%.4fs speedup=%.1fx mismatches=%d\n",
+  $directoryCount,
+  $legacyTime,
+  $builderTime,
+  $builderTime > 0 ? $legacyTime / $builderTime : 0,
+  $mismatches,
+);
+
+exit($mismatches == 0 ? 0 : 1);
@@ -0,0 +1,133 @@
+<?hh
+
+// --
+// Benchmark for TextTemplate\CompiledTemplate.
+//
+// Renders the directory and dashboard page templates of the html coverage
+// report with made up values, both through Template::render(), which runs
+// str_replace() over the whole template every time, and through the
+// segments TemplateFactory::getCompiled() splits it into once. Checks both
+// give the same page.
+//
+// usage: hhvm tests/performance/text-template.hh [renders] [rows]
+//
+// Defaults to 2000 renders of each template with 200 directory rows.
+// --
+
+$projectRoot = dirname(dirname(dirname(__FILE__)));
+
+require_once $projectRoot.'/vendor/autoload.php';
+
+use
+  SebastianBergmann\CodeCoverage\Report\Html\Renderer\Template\DirectoryItem
+;
+use SebastianBergmann\TextTemplate\Template;
+use SebastianBergmann\TextTemplate\TemplateFactory;
+
+$renders = 2000;
+$rowCount = 200;
+
+if (count($argv) > 1) {
+  $renders = intval($argv[1]);
+}
+
+if (count($argv) > 2) {
+  $rowCount = intval($argv[2]);
+}
+
+$templatePath =
+  $projectRoot.
+  '/src/SebastianBergmann/CodeCoverage/Report/Html/Renderer/Template/';
+
+$items = '';
+
+for ($i = 0; $i < $rowCount; $i++) {
+  $items .= DirectoryItem::render(
+    '<span class="glyphicon glyphicon-folder-open"></span> ',
+    sprintf('<a href="module%d/index.html">module%d</a>', $i, $i),
+    $i % 7,
+    'warning',
+    '57.14%',
+    '<div class="progress"></div>',
+    $i % 31,
+    'success',
+    '90.32%',
+    '<div class="progress"></div>',
+    '120&nbsp;/&nbsp;140',
+    'success',
+    '85.71%',
+    '<div class="progress"></div>',
+  );
+}
+
+$values = Map {
+  'id' => 'module',
+  'full_path' => '/synthetic/package/module',
+  'path_to_root' => '../../',
+  'breadcrumbs' => '<li><a href="../index.html">package</a></li>',
+  'date' => date('D M j G:i:s T Y'),
+  'version' => '1.0.0',
+  'runtime' => '<a href="https://hhvm.com/">HHVM 3.18</a>',
+  'generator' => ' and PHPUnit',
+  'low_upper_bound' => '50',
+  'high_lower_bound' => '90',
+  'items' => $items,
+  'insufficient_coverage_classes' => $items,
+  'insufficient_coverage_methods' => $items,
+  'project_risks_classes' => $items,
+  'project_risks_methods' => $items,
+  'complexity_class' => '[[57.14,7,"<a href=\"module.html\">Module<\/a>"]]',
+  'complexity_method' => '[[90.32,31,"<a href=\"module.html\">run<\/a>"]]',
+  'class_coverage_distribution' => '[0,0,0,0,0,1,0,0,0,0,0,0]',
+  'method_coverage_distribution' => '[0,0,0,0,0,0,0,0,0,1,0,0]',
+};
+
+$totalLegacy = 0.0;
+$totalCompiled = 0.0;
+$mismatches = 0;
+
+foreach (array('directory.html', 'dashboard.html') as $templateName) {
+
+  $template = new Template($templatePath.$templateName, '{{', '}}');
+
+  $start = microtime(true);
+  for ($n = 0; $n < $renders; $n++) {
+    $legacyPage = $template->render($values);
+  }
+  $legacyTime = microtime(true) - $start;
+
+  $start = microtime(true);
+  $compiled =
+    TemplateFactory::getCompiled($templatePath.$templateName, '{{', '}}');
+  for ($n = 0; $n < $renders; $n++) {
+    $compiledPage = $compiled->render($values);
+  }
+  $compiledTime = microtime(true) - $start;
+
+  if ($legacyPage !== $compiledPage) {
+    $mismatches++;
+  }
+
+  $totalLegacy += $legacyTime;
+  $totalCompiled += $compiledTime;
+
+  printf(
+    "%-16s slots=%3d bytes=%8d legacy=%8.4fs compiled=%8.4fs\n",
+    $templateName,
+    $compiled->getSlots()->count(),
+    strlen($compiledPage),
+    $legacyTime,
+    $compiledTime,
+  );
+
+}
+
+printf(
+  "total legacy=%.4fs compiled=%.4fs speedup=%.1fx mismatches=%d\n",
+  $totalLegacy,
+  $totalCompiled,
+  $totalCompiled > 0 ? $totalLegacy / $totalCompiled : 0,
+  $mismatches,
+);
+
+exit($mismatches == 0 ? 0 : 1);
@@ -15,12 +15,22 @@ Usage: phpunit [options] UnitTest [UnitTest.php]
 
 Code Coverage Options:
 
+  --coverage-aggregate <suite|class>
+                            Collect coverage across the whole suite or each
+                            test class instead of per test.
+  --coverage-baseline <file>
+                            Record line to test attribution to <file> for
+                            incremental runs.
   --coverage-clover <file>  Generate code coverage report in Clover XML format.
   --coverage-crap4j <file>  Generate code coverage report in Crap4J XML format.
   --coverage-html <dir>     Generate code coverage report in HTML format.
+  --coverage-incremental    Only run tests that touched files changed since
+                            the --coverage-baseline and merge in the rest.
   --coverage-php <file>     Export PHP_CodeCoverage object to file.
   --coverage-text=<file>    Generate code coverage report in text format.
                             Default: Standard output.
+  --coverage-workers <n>    Analyze whitelisted files and render HTML report
+                            pages with <n> forked workers.
   --coverage-xml <dir>      Generate code coverage report in PHPUnit XML format.
   --whitelist <dir>         Whitelist <dir> for code coverage analysis.
   --disable-coverage-ignore Disable annotations for ignoring code coverage.
@@ -45,6 +55,8 @@ Test Selection Options:
   --list-groups             List available test groups.
   --test-suffix ...         Only search for test in files with specified
                             suffix(es). Default: Test.php,.phpt
+  --discovery-index <file>  Find test classes by scanning test files, caching
+                            the scans in <file>, instead of including them.
 
 Test Execution Options:
 
@@ -57,6 +69,15 @@ Test Execution Options:
   --disallow-todo-tests     Disallow @todo-annotated tests.
 
   --process-isolation       Run each test in a separate PHP process.
+  --workers <n>             Run test classes across <n> forked workers.
+  --timing-database <file>  Record test times to <file> and use them to
+                            balance --workers and --shard.
+  --shard <k>/<n>           Only run shard <k> of <n>, split by test class.
+  --shard-manifest <file>   Write the classes of every shard to <file>, or
+                            follow the split in <file> when it exists.
+  --result-cache <file>     Record the outcome of every test to <file>.
+  --order-by <modes>        Run test classes ordered by defects, changed
+                            and/or fastest, e.g. --order-by=defects,fastest.
   --no-globals-backup       Do not backup and restore $GLOBALS for each test.
   --static-backup           Backup and restore static attributes for each test.
 
@@ -0,0 +1,95 @@
+<?hh // strict
+
+namespace SebastianBergmann\TokenStream\Tests;
+
+use Zynga\Framework\Testing\TestCase\V2\Base as TestCase;
+use Zynga\Framework\Environment\CodePath\V1\CodePath;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Close_Curly;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Curly_Open;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Function;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Open_Curly;
+
+use Zynga\CodeBase\V1\FileFactory;
+
+class BlockIndexTest extends TestCase {
+
+  protected function getFilesDirectory(): string {
+    return
+      CodePath::getRoot().
+      DIRECTORY_SEPARATOR.
+      'vendor'.
+      DIRECTORY_SEPARATOR.
+      'zynga'.
+      DIRECTORY_SEPARATOR.
+      'phpunit'.
+      DIRECTORY_SEPARATOR.
+      'tests'.
+      DIRECTORY_SEPARATOR.
+      'token-stream'.
+      DIRECTORY_SEPARATOR.
+      '_fixture'.
+      DIRECTORY_SEPARATOR;
+  }
+
+  public function testEndOfBlockMatchesCurlyPairs(): void {
+
+    $filename = $this->getFilesDirectory().'source.php';
+    $stream = FileFactory::get($filename)->stream();
+    $blockIndex = $stream->blockIndex();
+
+    $openStack = Vector {};
+    $pairCount = 0;
+
+    foreach ($stream->tokens() as $position => $token) {
+
+      if ($token instanceof PHP_Token_Open_Curly ||
+          $token instanceof PHP_Token_Curly_Open) {
+        $openStack->add($position);
+        continue;
+      }
+
+      if ($token instanceof PHP_Token_Close_Curly) {
+        $openPosition = $openStack->pop();
+        $this->assertEquals(
+          $token->getId(),
+          $blockIndex->getEndOfBlockId($openPosition),
+        );
+        $pairCount++;
+      }
+
+    }
+
+    $this->assertGreaterThan(0, $pairCount);
+
+  }
+
+  public function testFunctionEndsAtSemicolonOrCurly(): void {
+
+    $filename = $this->getFilesDirectory().'source5.php';
+    $stream = FileFactory::get($filename)->stream();
+
+    $endLines = Vector {};
+
+    foreach ($stream->tokens() as $token) {
+      if ($token instanceof PHP_Token_Function) {
+        $endLines->add($token->getEndLine());
+      }
+    }
+
+    // each of the function declarations within the fixture is a one liner.
+    $this->assertEquals(Vector {2, 3, 4, 5}, $endLines);
+
+  }
+
+  public function testLookupPastEndOfStream(): void {
+
+    $filename = $this->getFilesDirectory().'source5.php';
+    $stream = FileFactory::get($filename)->stream();
+    $blockIndex = $stream->blockIndex();
+
+    $this->assertEquals(-1, $blockIndex->getEndOfBlockId($stream->count()));
+    $this->assertEquals(-1, $blockIndex->getNextOpenCurlyId($stream->count()));
+
+  }
+
+}
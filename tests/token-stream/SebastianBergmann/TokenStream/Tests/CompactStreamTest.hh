@@ -0,0 +1,100 @@
+<?hh // strict
+
+namespace SebastianBergmann\TokenStream\Tests;
+
+use Zynga\Framework\Testing\TestCase\V2\Base as TestCase;
+use Zynga\Framework\Environment\CodePath\V1\CodePath;
+use SebastianBergmann\TokenStream\TokenInterface;
+use SebastianBergmann\TokenStream\Token\Stream;
+
+use Zynga\CodeBase\V1\FileFactory;
+
+class CompactStreamTest extends TestCase {
+
+  protected function getFilesDirectory(): string {
+    return
+      CodePath::getRoot().
+      DIRECTORY_SEPARATOR.
+      'vendor'.
+      DIRECTORY_SEPARATOR.
+      'zynga'.
+      DIRECTORY_SEPARATOR.
+      'phpunit'.
+      DIRECTORY_SEPARATOR.
+      'tests'.
+      DIRECTORY_SEPARATOR.
+      'token-stream'.
+      DIRECTORY_SEPARATOR.
+      '_fixture'.
+      DIRECTORY_SEPARATOR;
+  }
+
+  private function describeToken(?TokenInterface $token): string {
+    if (!$token instanceof TokenInterface) {
+      return '';
+    }
+    return
+      get_class($token).
+      ':'.
+      $token->getId().
+      ':'.
+      $token->getLine().
+      ':'.
+      strval($token->getText());
+  }
+
+  private function describeTokens(Stream $stream): Vector<string> {
+    $tokens = Vector {};
+    foreach ($stream->tokens() as $token) {
+      $tokens->add($this->describeToken($token));
+    }
+    return $tokens;
+  }
+
+  private function describeLines(Stream $stream): array<int, array<int>> {
+    $lines = array();
+    foreach ($stream->getLineToTokensForLine() as $lineNo => $tokens) {
+      $ids = array();
+      foreach ($tokens as $token) {
+        $ids[] = $token->getId();
+      }
+      $lines[$lineNo] = $ids;
+    }
+    ksort($lines);
+    return $lines;
+  }
+
+  public function testCompactThenExpandRestoresTheStream(): void {
+
+    foreach (array('source.php', 'source2.php', 'closure.php') as $fixture) {
+
+      $stream = FileFactory::get($this->getFilesDirectory().$fixture)->stream();
+
+      $tokens = $this->describeTokens($stream);
+      $lines = $this->describeLines($stream);
+
+      $stream->compact();
+
+      $this->assertTrue($stream->isCompact());
+      $this->assertEquals($tokens->count(), $stream->count());
+
+      // single lookups are served from the columns without expanding.
+      foreach ($tokens as $offset => $description) {
+        $this->assertEquals(
+          $description,
+          $this->describeToken($stream->get($offset)),
+        );
+      }
+
+      $this->assertTrue($stream->isCompact());
+      $this->assertNull($stream->get($tokens->count()));
+
+      $this->assertEquals($tokens, $this->describeTokens($stream));
+      $this->assertFalse($stream->isCompact());
+      $this->assertEquals($lines, $this->describeLines($stream));
+
+    }
+
+  }
+
+}
@@ -0,0 +1,211 @@
+<?hh // strict
+
+namespace SebastianBergmann\TokenStream\Tests;
+
+use Zynga\Framework\Testing\TestCase\V2\Base as TestCase;
+use Zynga\Framework\Environment\CodePath\V1\CodePath;
+use SebastianBergmann\TokenStream\TokenInterface;
+use SebastianBergmann\TokenStream\Token\CustomTokens;
+use SebastianBergmann\TokenStream\Token\Factory as TokenFactory;
+use SebastianBergmann\TokenStream\Token\Stream;
+use SebastianBergmann\TokenStream\Token\Stream\Scanner;
+use SebastianBergmann\TokenStream\Tokens\PHP_Token_Halt_Compiler;
+
+use Zynga\CodeBase\V1\File;
+
+class ScannerTest extends TestCase {
+
+  protected function getFilesDirectory(): string {
+    return
+      CodePath::getRoot().
+      DIRECTORY_SEPARATOR.
+      'vendor'.
+      DIRECTORY_SEPARATOR.
+      'zynga'.
+      DIRECTORY_SEPARATOR.
+      'phpunit'.
+      DIRECTORY_SEPARATOR.
+      'tests'.
+      DIRECTORY_SEPARATOR.
+      'token-stream'.
+      DIRECTORY_SEPARATOR.
+      '_fixture'.
+      DIRECTORY_SEPARATOR;
+  }
+
+  private function describeToken(TokenInterface $token): string {
+    return
+      get_class($token).
+      ':'.
+      $token->getId().
+      ':'.
+      $token->getLine().
+      ':'.
+      strval($token->getText());
+  }
+
+  private function legacyShortName(int $tokenId): string {
+    $shortName = '';
+    foreach (explode('_', substr(token_name($tokenId), 2)) as $namePart) {
+      if ($shortName != '') {
+        $shortName .= '_';
+      }
+      $shortName .= ucfirst(strtolower($namePart));
+    }
+    return $shortName;
+  }
+
+  // --
+  // The tokens Scanner::scan() made when it went through RawTokens: each
+  // token_get_all() element first copied into a raw token, a plain string
+  // one carrying its custom token id and a line of -1.
+  // --
+  private function legacyScan(File $file): Vector<string> {
+
+    $rawTokens = Vector {};
+
+    foreach (token_get_all($file->source()->get()) as $dirtyToken) {
+      if (is_array($dirtyToken)) {
+        $rawTokens->add(
+          tuple(intval($dirtyToken[0]), strval($dirtyToken[1]), false),
+        );
+      } else {
+        $rawTokens->add(
+          tuple(
+            CustomTokens::getTokenIdFromString(strval($dirtyToken)),
+            strval($dirtyToken),
+            true,
+          ),
+        );
+      }
+    }
+
+    $tokens = Vector {};
+
+    $id = 0;
+    $line = 1;
+    $lastNonWhitespaceTokenWasDoubleColon = false;
+
+    for ($i = 0; $i < $rawTokens->count(); ++$i) {
+
+      list($tokenId, $text, $isCustom) = $rawTokens[$i];
+
+      $newToken = null;
+      $skip = 0;
+
+      if ($isCustom === true) {
+        $tokenName = CustomTokens::getTokenClassNameFromId($tokenId);
+        if ($tokenName !== null) {
+          $newToken = TokenFactory::createTokenFromName($tokenName);
+        }
+      }
+
+      if ($tokenId == T_STRING) {
+        $customId = CustomTokens::getTokenIdFromString($text);
+        $tokenName = null;
+        if ($customId > 0) {
+          $tokenName = CustomTokens::getTokenClassNameFromId($customId);
+        }
+        if ($tokenName !== null) {
+          $newToken = TokenFactory::createTokenFromName($tokenName);
+        }
+      }
+
+      if ($newToken == null) {
+        if ($lastNonWhitespaceTokenWasDoubleColon && $tokenId == T_CLASS) {
+          $newToken =
+            TokenFactory::createTokenFromName('PHP_Token_Class_Name_Constant');
+        } else if ($tokenId == T_USE &&
+                   $rawTokens->containsKey($i + 2) &&
+                   $rawTokens[$i + 2][0] == T_FUNCTION) {
+          $newToken =
+            TokenFactory::createTokenFromName('PHP_Token_Use_Function');
+          $skip = 2;
+        } else {
+          $newToken = TokenFactory::createTokenFromTokenId($tokenId);
+          if ($newToken == null) {
+            $newToken = TokenFactory::createTokenFromName(
+              'PHP_Token_'.$this->legacyShortName($tokenId),
+            );
+          }
+        }
+      }
+
+      $id++;
+
+      if ($newToken instanceof TokenInterface) {
+        $tokens->add(get_class($newToken).':'.$id.':'.$line.':'.$text);
+      }
+
+      $line += substr_count($text, "\n");
+
+      if ($newToken instanceof PHP_Token_Halt_Compiler) {
+        break;
+      }
+
+      if ($tokenId == T_DOUBLE_COLON) {
+        $lastNonWhitespaceTokenWasDoubleColon = true;
+      } else if ($tokenId != T_WHITESPACE) {
+        $lastNonWhitespaceTokenWasDoubleColon = false;
+      }
+
+      $i += $skip;
+
+    }
+
+    return $tokens;
+
+  }
+
+  private function scan(string $filename): Vector<string> {
+
+    $file = new File($filename);
+    $stream = new Stream($file);
+
+    $scanner = new Scanner();
+    $scanner->scan($file, $stream);
+
+    $tokens = Vector {};
+
+    foreach ($stream->tokens() as $token) {
+      $tokens->add($this->describeToken($token));
+    }
+
+    return $tokens;
+
+  }
+
+  public function testScanMatchesTheRawTokenWalk(): void {
+
+    $filenames = Vector {};
+
+    foreach (glob($this->getFilesDirectory().'*') as $fixture) {
+      $filenames->add($fixture);
+    }
+
+    // the special cases: ::class, use function and anything after a halt.
+    $snippet = sys_get_temp_dir().'/scanner-test-'.getmypid().'.php';
+
+    file_put_contents(
+      $snippet,
+      "<?php\nnamespace Foo;\n\nuse function Bar\\baz;\n\n".
+      "\$a = Foo::class . \"x{\$b}\" . !\$c;\n".
+      "__halt_compiler();\nnot php at all {\n",
+    );
+
+    $filenames->add($snippet);
+
+    foreach ($filenames as $filename) {
+
+      $file = new File($filename);
+      $file->source()->load();
+
+      $this->assertEquals($this->legacyScan($file), $this->scan($filename));
+
+    }
+
+    @unlink($snippet);
+
+  }
+
+}